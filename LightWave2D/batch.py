@@ -0,0 +1,184 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+import copy
+from typing import NoReturn, List, Union
+import numpy
+from LightWave2D.experiment import Experiment
+from LightWave2D.pml import CPML
+from LightWave2D.recording import Recording, parse_recording
+from LightWave2D.detector import DetectorBank
+from LightWave2D.source import SourceTable
+from LightWave2D.stepper import UpdateCoefficients, NumpyStepper
+from pydantic.dataclasses import dataclass
+
+config_dict = dict(
+    kw_only=True,
+    slots=True,
+    extra='forbid',
+    arbitrary_types_allowed=True
+)
+
+
+@dataclass(config=config_dict)
+class BatchExperiment:
+    """
+    Run several variants of an experiment sharing the same Grid in a single time loop.
+
+    The fields of the B variants are stacked into (B, n_x, n_y) arrays and the
+    leapfrog update is applied to the whole stack at once, so the interpreter
+    overhead of a step is paid once per batch instead of once per variant.
+    Each variant keeps its own components (hence permittivity), sources,
+    detectors, PML and recording; after the run their results are found on
+    the variant Experiment objects exactly as after Experiment.run_fdtd.
+
+    Attributes:
+        experiments (List[Experiment]): The variants, all built on the same Grid instance.
+    """
+    experiments: List[Experiment]
+
+    def __post_init__(self):
+        if len(self.experiments) == 0:
+            raise ValueError("BatchExperiment requires at least one experiment.")
+
+        self.grid = self.experiments[0].grid
+
+        for experiment in self.experiments:
+            if experiment.grid is not self.grid:
+                raise ValueError("All the experiments of a BatchExperiment must share the same Grid instance.")
+
+            if experiment.dtype != self.experiments[0].dtype or experiment.monitor_dtype != self.experiments[0].monitor_dtype:
+                raise ValueError("All the experiments of a BatchExperiment must share the same precision.")
+
+            if experiment.plane_wave is not None:
+                raise ValueError("BatchExperiment does not support plane waves, run the variants separately.")
+
+    @property
+    def n_variant(self) -> int:
+        return len(self.experiments)
+
+    @property
+    def shape(self) -> tuple:
+        return (self.n_variant, *self.grid.shape)
+
+    def get_source_table(self, dtype: numpy.dtype) -> SourceTable:
+        """
+        Merge the sources of all the variants into one table addressing the stacked (B, n_x, n_y) field.
+
+        Args:
+            dtype (numpy.dtype): Floating point type of the fields.
+
+        Returns:
+            SourceTable: The table injecting the sources of every variant at once.
+        """
+        n_cells = self.grid.n_x * self.grid.n_y
+        sources, offsets = [], []
+        for index, experiment in enumerate(self.experiments):
+            sources += experiment.sources
+            offsets += [index * n_cells] * len(experiment.sources)
+
+        return SourceTable(sources=sources, time=self.grid.time_stamp, dtype=dtype, index_offsets=offsets)
+
+    def get_detector_bank(self, dtype: numpy.dtype) -> DetectorBank:
+        """
+        Merge the detectors of all the variants into one bank sampling the stacked (B, n_x, n_y) field.
+
+        Args:
+            dtype (numpy.dtype): Floating point type of the fields.
+
+        Returns:
+            DetectorBank: The bank sampling the detectors of every variant at once.
+        """
+        n_cells = self.grid.n_x * self.grid.n_y
+        detectors, offsets = [], []
+        for index, experiment in enumerate(self.experiments):
+            detectors += experiment.detectors
+            offsets += [index * n_cells] * len(experiment.detectors)
+
+        return DetectorBank(
+            grid=self.grid,
+            detectors=detectors,
+            dtype=dtype,
+            monitor_dtype=self.experiments[0].monitor_dtype,
+            index_offsets=offsets
+        )
+
+    def get_recording(self, recording: Union[str, Recording], dtype: numpy.dtype) -> Recording:
+        """
+        Allocate one recording of the stacked field and hand each variant a view of its own frames.
+
+        Args:
+            recording (str | Recording): Recording policy applied to every variant.
+            dtype (numpy.dtype): Floating point type of the fields.
+
+        Returns:
+            Recording: The recording of the stacked field, of frames of shape (B, n_x, n_y).
+        """
+        batch_recording = copy.deepcopy(parse_recording(recording))
+        batch_recording.initialize(grid=self.grid, dtype=dtype, batch_shape=(self.n_variant,))
+
+        for index, experiment in enumerate(self.experiments):
+            experiment.recording = copy.copy(batch_recording)
+            experiment.recording.data = batch_recording.data[:, index]
+            experiment.Ez_t = experiment.recording.data
+
+        return batch_recording
+
+    def run_fdtd(self, recording: Union[str, Recording] = 'all') -> NoReturn:
+        """
+        Run the FDTD simulation of all the variants together.
+
+        Args:
+            recording (str | Recording): Recording policy applied to every variant, 'all' (default), 'none' or a Recording.
+        """
+        variant_coefficients = [experiment.get_update_coefficients() for experiment in self.experiments]
+        stepper = NumpyStepper(coefficients=UpdateCoefficients.stack(variant_coefficients), shape=self.shape)
+
+        dtype = stepper.coefficients.dtype
+
+        Ez = numpy.zeros(self.shape, dtype=dtype)
+        Hx = numpy.zeros(self.shape, dtype=dtype)
+        Hy = numpy.zeros(self.shape, dtype=dtype)
+
+        batch_recording = self.get_recording(recording=recording, dtype=dtype)
+        detector_bank = self.get_detector_bank(dtype=dtype)
+
+        cpmls, non_linear = [], []
+        for index, experiment in enumerate(self.experiments):
+            if isinstance(experiment.pml, CPML):
+                experiment.pml.initialize(Ez=Ez[index], Hx=Hx[index], Hy=Hy[index], coefficients=variant_coefficients[index])
+                cpmls.append(experiment.pml)
+
+            non_linear += [(index, component) for component in experiment.components if component.is_non_linear]
+
+        source_table = self.get_source_table(dtype=dtype)
+
+        for iteration in range(self.grid.n_steps):
+
+            stepper.update_magnetic(Ez, Hx, Hy)
+
+            for cpml in cpmls:
+                cpml.update_magnetic()
+
+            stepper.update_electric(Ez, Hx, Hy)
+
+            for cpml in cpmls:
+                cpml.update_electric()
+
+            for index, component in non_linear:
+                component.add_non_linear_effect_to_field(Ez[index])
+
+            stepper.apply_damping(Ez)
+
+            source_table.inject(Ez, iteration)
+
+            batch_recording.record(iteration, Ez)
+
+            detector_bank.sample(iteration, Ez)
+
+        for experiment in self.experiments:
+            experiment.n_steps_run, experiment.stop_reason = self.grid.n_steps, None
+
+        detector_bank.finalize()
+
+# -
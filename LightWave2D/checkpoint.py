@@ -0,0 +1,132 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+import os
+import hashlib
+from typing import NoReturn, Dict, List
+import numpy
+from LightWave2D.grid import Grid
+from pydantic.dataclasses import dataclass
+
+config_dict = dict(
+    kw_only=True,
+    slots=True,
+    extra='forbid',
+    arbitrary_types_allowed=True
+)
+
+
+@dataclass(config=config_dict)
+class Checkpoint:
+    """
+    Policy writing the state of Experiment.run_fdtd to disk at regular intervals, and resuming from it.
+
+    The checkpoint holds everything the time loop carries from one step to
+    the next: Ez, Hx, Hy, the CPML auxiliary arrays, the detector traces, the
+    frequency monitor sums, the recorded frames, the state of the stop
+    criteria and the index of the next step. Restoring it and stepping on gives fields bitwise identical to an
+    uninterrupted run. The file is a single uncompressed .npz, written to a
+    temporary file first and moved over the previous checkpoint, so a run
+    killed while writing leaves the last complete checkpoint in place.
+
+    The state is stored with a fingerprint of the run (`get_fingerprint`):
+    the grid shape, time step and number of steps, the update coefficients,
+    the CPML coefficients and the source waveform table. A checkpoint of an
+    experiment whose sources, permittivity or PML were changed since is
+    refused instead of resumed from stale fields. A run that completes
+    removes its checkpoint.
+
+    Attributes:
+        path (str): File of the checkpoint.
+        every (int): Write a checkpoint every `every` time steps (default is 1000).
+        resume (bool): Whether run_fdtd continues from the checkpoint when the file exists (default is True).
+    """
+    path: str
+    every: int = 1000
+    resume: bool = True
+
+    def is_due(self, iteration: int) -> bool:
+        """
+        Whether a checkpoint is written after the given time step.
+
+        Args:
+            iteration (int): The time step index just completed.
+        """
+        return (iteration + 1) % self.every == 0
+
+    @staticmethod
+    def get_fingerprint(grid: Grid, arrays: List[numpy.ndarray]) -> str:
+        """
+        Digest of the run a state belongs to.
+
+        Args:
+            grid (Grid): The grid of the simulation mesh, its shape, time step and number of steps are hashed.
+            arrays (list): The arrays defining the run, e.g. update coefficients and source waveforms.
+
+        Returns:
+            str: The hexadecimal SHA-256 digest.
+        """
+        digest = hashlib.sha256(repr((grid.shape, grid.dt, grid.n_steps)).encode())
+
+        for array in arrays:
+            array = numpy.ascontiguousarray(array)
+            digest.update(repr((array.shape, array.dtype.str)).encode())
+            digest.update(array.tobytes())
+
+        return digest.hexdigest()
+
+    def save(self, next_iteration: int, state: Dict[str, numpy.ndarray], fingerprint: str) -> NoReturn:
+        """
+        Write the state atomically.
+
+        Args:
+            next_iteration (int): Index of the first time step still to run.
+            state (dict): The arrays carried by the time loop, by name.
+            fingerprint (str): Digest of the run, see `get_fingerprint`.
+        """
+        temporary_path = f"{self.path}.tmp"
+
+        with open(temporary_path, 'wb') as file:
+            numpy.savez(file, next_iteration=numpy.asarray(next_iteration), fingerprint=numpy.asarray(fingerprint), **state)
+            file.flush()
+            os.fsync(file.fileno())
+
+        os.replace(temporary_path, self.path)
+
+    def load(self, state: Dict[str, numpy.ndarray], fingerprint: str) -> int:
+        """
+        Restore the state in place if resuming is enabled and the file exists.
+
+        Args:
+            state (dict): The arrays carried by the time loop, by name, overwritten with the stored values.
+            fingerprint (str): Digest of the run, see `get_fingerprint`, which must be the one stored.
+
+        Returns:
+            int: Index of the first time step still to run, 0 when nothing was restored.
+        """
+        if not self.resume or not os.path.exists(self.path):
+            return 0
+
+        with numpy.load(self.path) as data:
+            if 'fingerprint' not in data.files or str(data['fingerprint']) != fingerprint:
+                raise ValueError(f"Checkpoint {self.path} was written by a different run: the grid, the coefficients or the sources changed.")
+
+            stored = set(data.files) - {'next_iteration', 'fingerprint'}
+            if stored != set(state):
+                raise ValueError(f"Checkpoint {self.path} does not match the experiment: it holds {sorted(stored)}, expected {sorted(state)}.")
+
+            for name, array in state.items():
+                if data[name].shape != array.shape or data[name].dtype != array.dtype:
+                    raise ValueError(f"Checkpoint {self.path} does not match the experiment: '{name}' has shape {data[name].shape} and type {data[name].dtype}, expected {array.shape} and {array.dtype}.")
+                array[...] = data[name]
+
+            return int(data['next_iteration'])
+
+    def discard(self) -> NoReturn:
+        """
+        Remove the checkpoint of a completed run, so that a later run starts from scratch.
+        """
+        if os.path.exists(self.path):
+            os.remove(self.path)
+
+# -
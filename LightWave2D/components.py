@@ -1,7 +1,7 @@
 #!/usr/bin/env python
 # -*- coding: utf-8 -*-
 
-from typing import NoReturn, Union, Tuple
+from typing import NoReturn, Union, Tuple, Optional
 from pydantic.dataclasses import dataclass
 import numpy
 from LightWave2D.physics import Physics
@@ -37,12 +37,14 @@ class BaseComponent():
         edgecolor (str): The color of the component's edge.
         alpha (float): Transparency level of the component.
         rotation (float): Rotation angle of the component.
+        chi_2 (float): Second-order non-linear coefficient, the component is linear when zero (default).
     """
     grid: Grid
     facecolor: str = 'lightblue'
     edgecolor: str = 'blue'
     alpha: float = 0.3
     rotation: float = 0
+    chi_2: float = 0
 
     def __post_init__(self):
         x0, y0 = self.position
@@ -52,23 +54,134 @@ class BaseComponent():
 
     def build_object(self) -> NoReturn:
         """
-        Build the permittivity mesh for the component.
-        """
-        self.epsilon_r_mesh = numpy.ones(self.grid.shape)  # Background permittivity
+        Rasterize the component on the grid, restricted to its rotated bounding box.
 
+        The result is stored as a sparse patch: `patch_slice` locates the
+        bounding box in the grid and `mask` flags the cells of the box that
+        lie inside the component.
+        """
         self.compute_polygon()
 
-        self.path = Path(self.polygon.exterior.coords)
+        rotation = mpl.transforms.Affine2D().rotate_around(self.coordinate.x, self.coordinate.y, self.rotation)
+
+        polygons = getattr(self.polygon, 'geoms', [self.polygon])
+
+        self.rings = [
+            (
+                Path(np.asarray(polygon.exterior.coords)[:, :2]).transformed(rotation),
+                [Path(np.asarray(ring.coords)[:, :2]).transformed(rotation) for ring in polygon.interiors]
+            ) for polygon in polygons
+        ]
+
+        self.path = Path.make_compound_path(*[exterior for exterior, _ in self.rings])
+
+        self.patch_slice = self.get_patch_slice()
+
+        x_mesh, y_mesh = numpy.meshgrid(self.grid.x_stamp[self.patch_slice[0]], self.grid.y_stamp[self.patch_slice[1]], indexing='ij')
+
+        self.mask = self.contains_points(numpy.c_[x_mesh.ravel(), y_mesh.ravel()]).reshape(x_mesh.shape)
+
+        rows, cols = numpy.nonzero(self.mask)
+        self.flat_index = numpy.ravel_multi_index((rows + self.patch_slice[0].start, cols + self.patch_slice[1].start), self.grid.shape)
+
+        self.fill_fractions = {}
+
+    def get_patch_slice(self) -> Tuple[slice, slice]:
+        """
+        Index slices of the grid covering the rotated bounding box of the component.
+
+        Returns:
+            tuple: Slices along x and y.
+        """
+        extents = self.path.get_extents()
+
+        i_start = int(numpy.clip(numpy.floor(extents.x0 / self.grid.dx), 0, self.grid.n_x - 1))
+        i_stop = int(numpy.clip(numpy.ceil(extents.x1 / self.grid.dx), 0, self.grid.n_x - 1))
+        j_start = int(numpy.clip(numpy.floor(extents.y0 / self.grid.dy), 0, self.grid.n_y - 1))
+        j_stop = int(numpy.clip(numpy.ceil(extents.y1 / self.grid.dy), 0, self.grid.n_y - 1))
+
+        return slice(i_start, i_stop + 1), slice(j_start, j_stop + 1)
+
+    def contains_points(self, points: numpy.ndarray) -> numpy.ndarray:
+        """
+        Test which points lie inside the (rotated) component, holes excluded.
+
+        Args:
+            points (numpy.ndarray): Array of shape (n, 2) of (x, y) coordinates.
+
+        Returns:
+            numpy.ndarray: Boolean array of shape (n,).
+        """
+        inside = numpy.zeros(len(points), dtype=bool)
+
+        for exterior, interiors in self.rings:
+            inside_polygon = exterior.contains_points(points)
+            for interior in interiors:
+                inside_polygon &= ~interior.contains_points(points)
+            inside |= inside_polygon
+
+        return inside
 
-        self.path = self.path.transformed(mpl.transforms.Affine2D().rotate_around(self.coordinate.x, self.coordinate.y, self.rotation))
+    def get_fill_fraction(self, n_samples: int = 8) -> numpy.ndarray:
+        """
+        Fraction of the area of every cell of the patch covered by the component.
+
+        A cell is the dx by dy square centred on its Ez node. Cells whose 3 x 3
+        neighbourhood is entirely inside or outside the component keep the
+        value of `mask`; the cells along the boundary are sampled on a regular
+        n_samples x n_samples sub-grid. Features thinner than a cell whose
+        footprint contains no Ez node are not seen. The result is cached.
+
+        Args:
+            n_samples (int): Number of sub-samples per cell side (default is 8).
+
+        Returns:
+            numpy.ndarray: Fractions in [0, 1], same shape as `mask`.
+        """
+        if n_samples in self.fill_fractions:
+            return self.fill_fractions[n_samples]
+
+        padded = numpy.pad(self.mask, 1, constant_values=False)
+        n_x, n_y = self.mask.shape
+
+        boundary = numpy.zeros(self.mask.shape, dtype=bool)
+        for di in range(3):
+            for dj in range(3):
+                boundary |= padded[di:di + n_x, dj:dj + n_y] != self.mask
+
+        rows, cols = numpy.nonzero(boundary)
+        offsets = (numpy.arange(n_samples) + 0.5) / n_samples - 0.5
+
+        x = self.grid.x_stamp[self.patch_slice[0]][rows, None, None] + offsets[None, :, None] * self.grid.dx
+        y = self.grid.y_stamp[self.patch_slice[1]][cols, None, None] + offsets[None, None, :] * self.grid.dy
+        x, y = numpy.broadcast_arrays(x, y)
+
+        inside = self.contains_points(numpy.c_[x.ravel(), y.ravel()]).reshape(rows.size, -1)
+
+        fraction = self.mask.astype(float)
+        fraction[rows, cols] = inside.mean(axis=1)
 
-        x_mesh, y_mesh = numpy.meshgrid(self.grid.x_stamp, self.grid.y_stamp)
+        self.fill_fractions[n_samples] = fraction
 
-        coordinates = numpy.c_[x_mesh.T.flatten(), y_mesh.T.flatten()]
+        return fraction
 
-        self.idx = self.path.contains_points(coordinates).astype(bool).reshape(self.epsilon_r_mesh.shape)
+    @property
+    def idx(self) -> numpy.ndarray:
+        """
+        Full-grid boolean mask of the component, expanded from the sparse patch on demand.
+        """
+        idx = numpy.zeros(self.grid.shape, dtype=bool)
+        idx[self.patch_slice] = self.mask
+        return idx
 
-        self.epsilon_r_mesh[self.idx] = self.epsilon_r
+    @property
+    def epsilon_r_mesh(self) -> numpy.ndarray:
+        """
+        Full-grid relative permittivity of the component alone, expanded from the sparse patch on demand.
+        """
+        epsilon_r_mesh = numpy.ones(self.grid.shape)
+        epsilon_r_mesh[self.idx] = self.epsilon_r
+        return epsilon_r_mesh
 
     def add_to_ax(self, ax: plt.axis) -> PatchCollection:
         """
@@ -106,25 +219,59 @@ class BaseComponent():
 
         plt.show()
 
-    def add_to_mesh(self, epsilon_r_mesh: numpy.ndarray) -> NoReturn:
+    def add_to_mesh(self, epsilon_r_mesh: numpy.ndarray, row_offset: int = 0, subpixel_samples: Optional[int] = None) -> NoReturn:
         """
-        Add the component's permittivity to the provided mesh.
+        Paint the component's permittivity onto the provided mesh, touching its patch only.
 
         Args:
             epsilon_r_mesh (np.ndarray): The permittivity mesh to be updated.
+            row_offset (int): Grid row of the first row of the mesh, for meshes holding a band of rows of the grid (default is 0).
+            subpixel_samples (int): If given, the cells cut by the boundary are blended with what is already painted,
+                weighted by the covered area sampled with `get_fill_fraction`. Default is the plain staircase.
         """
-        epsilon_r_mesh += self.epsilon_r_mesh
+        x_slice, y_slice = self.patch_slice
+
+        start = max(x_slice.start, row_offset)
+        stop = min(x_slice.stop, row_offset + epsilon_r_mesh.shape[0])
+        if start >= stop:
+            return
+
+        patch = epsilon_r_mesh[start - row_offset:stop - row_offset, y_slice]
+
+        if subpixel_samples is None:
+            patch[self.mask[start - x_slice.start:stop - x_slice.start]] = self.epsilon_r
+            return
 
-    def add_non_linear_effect_to_field(self, field: numpy.ndarray) -> NoReturn:
+        fraction = self.get_fill_fraction(n_samples=subpixel_samples)[start - x_slice.start:stop - x_slice.start]
+        patch *= 1 - fraction
+        patch += fraction * self.epsilon_r
+
+    @property
+    def is_non_linear(self) -> bool:
+        """
+        Whether the component contributes a non-linear term to the field update.
+        """
+        return self.chi_2 != 0
+
+    def add_non_linear_effect_to_field(self, field: numpy.ndarray, flat_index: Optional[numpy.ndarray] = None) -> NoReturn:
         """
-        Add non-linear effects to the field.
+        Add the second-order non-linear term to the field, over the component's cells only.
 
         Args:
-            field (np.ndarray): The field to which non-linear effects will be added.
+            field (np.ndarray): The C-contiguous field to which non-linear effects will be added.
+            flat_index (np.ndarray): Flat indices of the component's cells in `field`, default is `flat_index` for a field of the grid shape.
         """
-        chi_2 = 1e10
+        if not self.is_non_linear:
+            return
+
+        if flat_index is None:
+            flat_index = self.flat_index
+
+        factor = self.grid.dt**2 / (self.epsilon_r * Physics.epsilon_0 * Physics.mu_0) * self.chi_2
 
-        field += self.idx * self.grid.dt**2 / (self.epsilon_r_mesh * Physics.epsilon_0 * Physics.mu_0) * chi_2 * field ** 2
+        flat_field = field.reshape(-1)
+        values = flat_field[flat_index]
+        flat_field[flat_index] = values + factor * values ** 2
 
 
 @dataclass(config=config_dict)
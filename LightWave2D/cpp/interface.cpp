@@ -0,0 +1,188 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include "yee_engine.h"
+
+namespace py = pybind11;
+
+template <typename real>
+using array_t = py::array_t<real, py::array::c_style>;
+
+using index_t = py::array_t<std::ptrdiff_t, py::array::c_style | py::array::forcecast>;
+
+
+template <typename real>
+static void check_array(const array_t<real> &array, const std::ptrdiff_t n_x, const std::ptrdiff_t n_y, const std::string &name)
+{
+    if (array.ndim() != 2 || array.shape(0) != n_x || array.shape(1) != n_y)
+        throw std::invalid_argument(name + " must be a 2D array of shape (n_x, n_y).");
+
+    if (!(array.flags() & py::array::c_style))
+        throw std::invalid_argument(name + " must be C-contiguous.");
+}
+
+
+template <typename real>
+void update_magnetic(const array_t<real> &Ez, array_t<real> &Hx, array_t<real> &Hy, const array_t<real> &Db_x, const array_t<real> &Db_y)
+{
+    const std::ptrdiff_t n_x = Ez.shape(0), n_y = Ez.shape(1);
+
+    check_array(Ez, n_x, n_y, "Ez");
+    check_array(Hx, n_x, n_y, "Hx");
+    check_array(Hy, n_x, n_y, "Hy");
+    check_array(Db_x, n_x, n_y, "Db_x");
+    check_array(Db_y, n_x, n_y, "Db_y");
+
+    const real *Ez_ptr = Ez.data(), *Db_x_ptr = Db_x.data(), *Db_y_ptr = Db_y.data();
+    real *Hx_ptr = Hx.mutable_data(), *Hy_ptr = Hy.mutable_data();
+
+    py::gil_scoped_release release;
+    yee::update_magnetic(Ez_ptr, Hx_ptr, Hy_ptr, Db_x_ptr, Db_y_ptr, n_x, n_y);
+}
+
+
+template <typename real>
+void update_electric(array_t<real> &Ez, const array_t<real> &Hx, const array_t<real> &Hy, const array_t<real> &Cb_x, const array_t<real> &Cb_y)
+{
+    const std::ptrdiff_t n_x = Ez.shape(0), n_y = Ez.shape(1);
+
+    check_array(Ez, n_x, n_y, "Ez");
+    check_array(Hx, n_x, n_y, "Hx");
+    check_array(Hy, n_x, n_y, "Hy");
+    check_array(Cb_x, n_x, n_y, "Cb_x");
+    check_array(Cb_y, n_x, n_y, "Cb_y");
+
+    real *Ez_ptr = Ez.mutable_data();
+    const real *Hx_ptr = Hx.data(), *Hy_ptr = Hy.data(), *Cb_x_ptr = Cb_x.data(), *Cb_y_ptr = Cb_y.data();
+
+    py::gil_scoped_release release;
+    yee::update_electric(Ez_ptr, Hx_ptr, Hy_ptr, Cb_x_ptr, Cb_y_ptr, n_x, n_y);
+}
+
+
+template <typename real>
+void apply_damping(array_t<real> &Ez, const array_t<real> &Ca)
+{
+    const std::ptrdiff_t n_x = Ez.shape(0), n_y = Ez.shape(1);
+
+    check_array(Ez, n_x, n_y, "Ez");
+    check_array(Ca, n_x, n_y, "Ca");
+
+    real *Ez_ptr = Ez.mutable_data();
+    const real *Ca_ptr = Ca.data();
+
+    py::gil_scoped_release release;
+    yee::apply_damping(Ez_ptr, Ca_ptr, n_x, n_y);
+}
+
+
+template <typename real>
+array_t<real> advance_tiled(
+    const array_t<real> &Ez, const array_t<real> &Hx, const array_t<real> &Hy,
+    array_t<real> &Ez_out, array_t<real> &Hx_out, array_t<real> &Hy_out,
+    const array_t<real> &Db_x, const array_t<real> &Db_y, const array_t<real> &Cb_x, const array_t<real> &Cb_y, const std::optional<array_t<real>> &Ca,
+    const std::ptrdiff_t n_steps, const std::ptrdiff_t tile_x, const std::ptrdiff_t tile_y,
+    const index_t &source_index, const array_t<real> &source_values, const index_t &probe_index)
+{
+    const std::ptrdiff_t n_x = Ez.shape(0), n_y = Ez.shape(1);
+
+    check_array(Ez, n_x, n_y, "Ez");
+    check_array(Hx, n_x, n_y, "Hx");
+    check_array(Hy, n_x, n_y, "Hy");
+    check_array(Ez_out, n_x, n_y, "Ez_out");
+    check_array(Hx_out, n_x, n_y, "Hx_out");
+    check_array(Hy_out, n_x, n_y, "Hy_out");
+    check_array(Db_x, n_x, n_y, "Db_x");
+    check_array(Db_y, n_x, n_y, "Db_y");
+    check_array(Cb_x, n_x, n_y, "Cb_x");
+    check_array(Cb_y, n_x, n_y, "Cb_y");
+    if (Ca)
+        check_array(*Ca, n_x, n_y, "Ca");
+
+    if (n_steps < 1 || tile_x < 1 || tile_y < 1)
+        throw std::invalid_argument("n_steps, tile_x and tile_y must be positive.");
+
+    const std::ptrdiff_t n_source = source_index.size(), n_probe = probe_index.size();
+
+    if (source_values.ndim() != 2 || source_values.shape(0) != n_steps || source_values.shape(1) != n_source)
+        throw std::invalid_argument("source_values must be a 2D array of shape (n_steps, n_source).");
+
+    for (std::ptrdiff_t c = 0; c < n_source; ++c)
+        if (source_index.data()[c] < 0 || source_index.data()[c] >= n_x * n_y)
+            throw std::invalid_argument("source_index out of the grid.");
+
+    for (std::ptrdiff_t p = 0; p < n_probe; ++p)
+        if (probe_index.data()[p] < 0 || probe_index.data()[p] >= n_x * n_y)
+            throw std::invalid_argument("probe_index out of the grid.");
+
+    array_t<real> probe_values({n_steps, n_probe});
+
+    const real *Ez_ptr = Ez.data(), *Hx_ptr = Hx.data(), *Hy_ptr = Hy.data();
+    real *Ez_out_ptr = Ez_out.mutable_data(), *Hx_out_ptr = Hx_out.mutable_data(), *Hy_out_ptr = Hy_out.mutable_data();
+    const real *Ca_ptr = Ca ? Ca->data() : nullptr;
+    real *probe_ptr = probe_values.mutable_data();
+
+    {
+        py::gil_scoped_release release;
+        yee::advance_tiled(
+            Ez_ptr, Hx_ptr, Hy_ptr, Ez_out_ptr, Hx_out_ptr, Hy_out_ptr,
+            Db_x.data(), Db_y.data(), Cb_x.data(), Cb_y.data(), Ca_ptr,
+            n_x, n_y, n_steps, tile_x, tile_y,
+            source_index.data(), source_values.data(), n_source,
+            probe_index.data(), probe_ptr, n_probe
+        );
+    }
+
+    return probe_values;
+}
+
+
+template <typename real>
+static void bind_kernels(py::module_ &module)
+{
+    module.def(
+        "update_magnetic",
+        &update_magnetic<real>,
+        py::arg("Ez"), py::arg("Hx").noconvert(), py::arg("Hy").noconvert(), py::arg("Db_x"), py::arg("Db_y"),
+        "Advance Hx and Hy by half a time step, in place."
+    );
+
+    module.def(
+        "update_electric",
+        &update_electric<real>,
+        py::arg("Ez").noconvert(), py::arg("Hx"), py::arg("Hy"), py::arg("Cb_x"), py::arg("Cb_y"),
+        "Advance Ez by half a time step from the curl of H, in place."
+    );
+
+    module.def(
+        "apply_damping",
+        &apply_damping<real>,
+        py::arg("Ez").noconvert(), py::arg("Ca"),
+        "Apply the PML damping factor to Ez, in place."
+    );
+
+    module.def(
+        "advance_tiled",
+        &advance_tiled<real>,
+        py::arg("Ez"), py::arg("Hx"), py::arg("Hy"),
+        py::arg("Ez_out").noconvert(), py::arg("Hx_out").noconvert(), py::arg("Hy_out").noconvert(),
+        py::arg("Db_x"), py::arg("Db_y"), py::arg("Cb_x"), py::arg("Cb_y"), py::arg("Ca"),
+        py::arg("n_steps"), py::arg("tile_x"), py::arg("tile_y"),
+        py::arg("source_index"), py::arg("source_values"), py::arg("probe_index"),
+        "Advance the fields n_steps time steps with overlapped temporal tiling, writing the result to the output arrays. Returns Ez at the probes after every step."
+    );
+}
+
+
+PYBIND11_MODULE(interface_yee, module)
+{
+    module.doc() = "Compiled in-place leapfrog kernels for the 2D TMz Yee scheme, in double and single precision.";
+
+    // The in-place arguments are noconvert, so each call dispatches on the dtype of the fields.
+    bind_kernels<double>(module);
+    bind_kernels<float>(module);
+}
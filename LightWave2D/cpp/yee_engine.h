@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+// Leapfrog kernels for the TMz Yee update used by Experiment.run_fdtd.
+//
+// The kernels are templated on the floating point type (float or double),
+// fields and coefficients of a call share the same type.
+//
+// All fields and coefficients are stored row-major with shape (n_x, n_y),
+// i.e. the element (i, j) lives at i * n_y + j, exactly as the numpy arrays
+// handed over from Python. The coefficients are the ones assembled by
+// LightWave2D.stepper.UpdateCoefficients. Each expression mirrors the
+// operation order of the numpy engine so that both backends produce bitwise
+// identical fields (the module is built with -ffp-contract=off to keep the
+// compiler from fusing them into FMAs).
+
+namespace yee {
+
+    template <typename real>
+    inline void update_magnetic(
+        const real *Ez, real *Hx, real *Hy,
+        const real *Db_x, const real *Db_y,
+        const std::ptrdiff_t n_x, const std::ptrdiff_t n_y)
+    {
+        #pragma omp parallel for schedule(static)
+        for (std::ptrdiff_t i = 0; i < n_x; ++i)
+        {
+            const std::ptrdiff_t row = i * n_y;
+
+            for (std::ptrdiff_t j = 0; j < n_y - 1; ++j)
+            {
+                const std::ptrdiff_t k = row + j;
+                Hx[k] -= Db_x[k] * (Ez[k + 1] - Ez[k]);
+            }
+
+            if (i == n_x - 1)
+                continue;
+
+            for (std::ptrdiff_t j = 0; j < n_y; ++j)
+            {
+                const std::ptrdiff_t k = row + j;
+                Hy[k] += Db_y[k] * (Ez[k + n_y] - Ez[k]);
+            }
+        }
+    }
+
+    template <typename real>
+    inline void update_electric(
+        real *Ez, const real *Hx, const real *Hy,
+        const real *Cb_x, const real *Cb_y,
+        const std::ptrdiff_t n_x, const std::ptrdiff_t n_y)
+    {
+        #pragma omp parallel for schedule(static)
+        for (std::ptrdiff_t i = 1; i < n_x - 1; ++i)
+        {
+            const std::ptrdiff_t row = i * n_y;
+
+            for (std::ptrdiff_t j = 1; j < n_y - 1; ++j)
+            {
+                const std::ptrdiff_t k = row + j;
+                Ez[k] += Cb_x[k] * (Hy[k] - Hy[k - n_y]) - Cb_y[k] * (Hx[k] - Hx[k - 1]);
+            }
+        }
+    }
+
+    template <typename real>
+    inline void apply_damping(
+        real *Ez, const real *Ca,
+        const std::ptrdiff_t n_x, const std::ptrdiff_t n_y)
+    {
+        #pragma omp parallel for schedule(static)
+        for (std::ptrdiff_t i = 0; i < n_x; ++i)
+        {
+            const std::ptrdiff_t row = i * n_y;
+
+            for (std::ptrdiff_t j = 0; j < n_y; ++j)
+                Ez[row + j] *= Ca[row + j];
+        }
+    }
+
+    // Overlapped temporal tiling of the leapfrog.
+    //
+    // The grid is cut into tiles of tile_x x tile_y cells. Each tile copies
+    // the fields of its cells plus a halo of n_steps (+1 on the upper sides)
+    // cells into private buffers sized to stay in cache, advances them
+    // n_steps time steps there, and writes its own cells back to the output
+    // arrays. One leapfrog step only propagates information by one cell, so
+    // after n_steps the tile cells are exact while the redundant halo has
+    // been spoiled from the outside in. Inputs and outputs are distinct
+    // arrays (double buffering), tiles therefore never read a neighbour's
+    // updated cells and run concurrently.
+    //
+    // Within a tile the expressions are the ones of the plain kernels above
+    // and the buffer edges behave like the grid edges, so the result is
+    // bitwise identical to n_steps calls of update_magnetic, update_electric,
+    // apply_damping followed by the hard sources and the probes.
+    //
+    // Sources write source_values[s * n_source + c] at the grid cell
+    // source_index[c] after step s, in order (the last write wins). Probes
+    // read Ez at probe_index[p] after the sources into
+    // probe_values[s * n_probe + p].
+
+    struct TileWindow
+    {
+        std::ptrdiff_t i0, i1, j0, j1;   // cells owned by the tile
+        std::ptrdiff_t x0, x1, y0, y1;   // cells held in the buffers, halo included
+    };
+
+    template <typename real>
+    inline void advance_tile(
+        const TileWindow &w,
+        const real *Ez_in, const real *Hx_in, const real *Hy_in,
+        real *Ez_out, real *Hx_out, real *Hy_out,
+        const real *Db_x, const real *Db_y, const real *Cb_x, const real *Cb_y, const real *Ca,
+        const std::ptrdiff_t n_y, const std::ptrdiff_t n_steps,
+        const std::ptrdiff_t *source_index, const real *source_values, const std::ptrdiff_t n_source,
+        const std::ptrdiff_t *probe_index, real *probe_values, const std::ptrdiff_t n_probe,
+        std::vector<real> &buffer)
+    {
+        const std::ptrdiff_t nx = w.x1 - w.x0, ny = w.y1 - w.y0, size = nx * ny;
+
+        buffer.resize(3 * size);
+        real *Ez = buffer.data(), *Hx = Ez + size, *Hy = Hx + size;
+
+        auto global = [&](std::ptrdiff_t i, std::ptrdiff_t j) { return (i + w.x0) * n_y + j + w.y0; };
+
+        for (std::ptrdiff_t i = 0; i < nx; ++i)
+        {
+            const std::ptrdiff_t g = global(i, 0);
+            std::copy(Ez_in + g, Ez_in + g + ny, Ez + i * ny);
+            std::copy(Hx_in + g, Hx_in + g + ny, Hx + i * ny);
+            std::copy(Hy_in + g, Hy_in + g + ny, Hy + i * ny);
+        }
+
+        std::vector<std::ptrdiff_t> sources, source_columns, probes, probe_columns;
+
+        for (std::ptrdiff_t c = 0; c < n_source; ++c)
+        {
+            const std::ptrdiff_t i = source_index[c] / n_y - w.x0, j = source_index[c] % n_y - w.y0;
+            if (i >= 0 && i < nx && j >= 0 && j < ny)
+            {
+                sources.push_back(i * ny + j);
+                source_columns.push_back(c);
+            }
+        }
+
+        for (std::ptrdiff_t p = 0; p < n_probe; ++p)
+        {
+            const std::ptrdiff_t i = probe_index[p] / n_y, j = probe_index[p] % n_y;
+            if (i >= w.i0 && i < w.i1 && j >= w.j0 && j < w.j1)
+            {
+                probes.push_back((i - w.x0) * ny + j - w.y0);
+                probe_columns.push_back(p);
+            }
+        }
+
+        for (std::ptrdiff_t s = 0; s < n_steps; ++s)
+        {
+            for (std::ptrdiff_t i = 0; i < nx; ++i)
+            {
+                for (std::ptrdiff_t j = 0; j < ny - 1; ++j)
+                {
+                    const std::ptrdiff_t k = i * ny + j;
+                    Hx[k] -= Db_x[global(i, j)] * (Ez[k + 1] - Ez[k]);
+                }
+
+                if (i == nx - 1)
+                    continue;
+
+                for (std::ptrdiff_t j = 0; j < ny; ++j)
+                {
+                    const std::ptrdiff_t k = i * ny + j;
+                    Hy[k] += Db_y[global(i, j)] * (Ez[k + ny] - Ez[k]);
+                }
+            }
+
+            for (std::ptrdiff_t i = 1; i < nx - 1; ++i)
+                for (std::ptrdiff_t j = 1; j < ny - 1; ++j)
+                {
+                    const std::ptrdiff_t k = i * ny + j, g = global(i, j);
+                    Ez[k] += Cb_x[g] * (Hy[k] - Hy[k - ny]) - Cb_y[g] * (Hx[k] - Hx[k - 1]);
+                }
+
+            if (Ca != nullptr)
+                for (std::ptrdiff_t i = 0; i < nx; ++i)
+                    for (std::ptrdiff_t j = 0; j < ny; ++j)
+                        Ez[i * ny + j] *= Ca[global(i, j)];
+
+            for (std::size_t c = 0; c < sources.size(); ++c)
+                Ez[sources[c]] = source_values[s * n_source + source_columns[c]];
+
+            for (std::size_t p = 0; p < probes.size(); ++p)
+                probe_values[s * n_probe + probe_columns[p]] = Ez[probes[p]];
+        }
+
+        for (std::ptrdiff_t i = w.i0; i < w.i1; ++i)
+        {
+            const std::ptrdiff_t k = (i - w.x0) * ny + w.j0 - w.y0, g = i * n_y + w.j0, n = w.j1 - w.j0;
+            std::copy(Ez + k, Ez + k + n, Ez_out + g);
+            std::copy(Hx + k, Hx + k + n, Hx_out + g);
+            std::copy(Hy + k, Hy + k + n, Hy_out + g);
+        }
+    }
+
+    template <typename real>
+    inline void advance_tiled(
+        const real *Ez_in, const real *Hx_in, const real *Hy_in,
+        real *Ez_out, real *Hx_out, real *Hy_out,
+        const real *Db_x, const real *Db_y, const real *Cb_x, const real *Cb_y, const real *Ca,
+        const std::ptrdiff_t n_x, const std::ptrdiff_t n_y, const std::ptrdiff_t n_steps,
+        const std::ptrdiff_t tile_x, const std::ptrdiff_t tile_y,
+        const std::ptrdiff_t *source_index, const real *source_values, const std::ptrdiff_t n_source,
+        const std::ptrdiff_t *probe_index, real *probe_values, const std::ptrdiff_t n_probe)
+    {
+        const std::ptrdiff_t n_tile_x = (n_x + tile_x - 1) / tile_x, n_tile_y = (n_y + tile_y - 1) / tile_y;
+
+        #pragma omp parallel
+        {
+            std::vector<real> buffer;
+
+            #pragma omp for schedule(dynamic) collapse(2)
+            for (std::ptrdiff_t a = 0; a < n_tile_x; ++a)
+                for (std::ptrdiff_t b = 0; b < n_tile_y; ++b)
+                {
+                    TileWindow w;
+                    w.i0 = a * tile_x;
+                    w.i1 = std::min(w.i0 + tile_x, n_x);
+                    w.j0 = b * tile_y;
+                    w.j1 = std::min(w.j0 + tile_y, n_y);
+                    w.x0 = std::max<std::ptrdiff_t>(w.i0 - n_steps, 0);
+                    w.x1 = std::min(w.i1 + n_steps + 1, n_x);
+                    w.y0 = std::max<std::ptrdiff_t>(w.j0 - n_steps, 0);
+                    w.y1 = std::min(w.j1 + n_steps + 1, n_y);
+
+                    advance_tile(
+                        w, Ez_in, Hx_in, Hy_in, Ez_out, Hx_out, Hy_out,
+                        Db_x, Db_y, Cb_x, Cb_y, Ca, n_y, n_steps,
+                        source_index, source_values, n_source,
+                        probe_index, probe_values, n_probe,
+                        buffer
+                    );
+                }
+        }
+    }
+
+} // namespace yee
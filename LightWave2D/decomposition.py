@@ -0,0 +1,218 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+import os
+from typing import NoReturn, Optional, Tuple, List
+from concurrent.futures import ThreadPoolExecutor
+import numpy
+
+
+def get_available_cores() -> int:
+    """Number of cores the current process is allowed to run on."""
+    if hasattr(os, 'sched_getaffinity'):
+        return len(os.sched_getaffinity(0))
+
+    return os.cpu_count() or 1
+
+
+class SlabPartition:
+    """
+    Split the n_x rows of the grid into contiguous slabs of near-equal size.
+
+    The fields are stored row-major so a slab of rows is a contiguous block of
+    memory, and two neighbouring slabs only share the single row on each side
+    of their interface: the leapfrog needs Ez of the next row to update Hy and
+    Hy of the previous row to update Ez, the halo is therefore one row deep.
+
+    Args:
+        n_x (int): Number of rows of the grid.
+        n_slabs (int): Requested number of slabs, clipped to n_x.
+    """
+
+    def __init__(self, n_x: int, n_slabs: int):
+        assert n_slabs > 0, f"Invalid number of slabs: {n_slabs}, it must be positive."
+
+        self.n_x = n_x
+        self.n_slabs = min(n_slabs, n_x)
+
+        bounds = numpy.linspace(0, n_x, self.n_slabs + 1).round().astype(int)
+        self.bounds = list(zip(bounds[:-1].tolist(), bounds[1:].tolist()))
+
+    def __len__(self) -> int:
+        return self.n_slabs
+
+    def get_rows(self, index: int) -> Tuple[int, int]:
+        """
+        Rows owned by a slab.
+
+        Args:
+            index (int): Index of the slab (or rank).
+
+        Returns:
+            tuple: (start, stop) of the owned rows.
+        """
+        return self.bounds[index]
+
+    def get_halo_rows(self, index: int) -> Tuple[int, int]:
+        """
+        Owned rows of a slab extended by one halo row on each side where a neighbour exists.
+
+        Args:
+            index (int): Index of the slab (or rank).
+
+        Returns:
+            tuple: (start, stop) of the rows held locally.
+        """
+        start, stop = self.bounds[index]
+        return max(start - 1, 0), min(stop + 1, self.n_x)
+
+
+class SlabStepper:
+    """
+    Leapfrog restricted to the rows [start, stop) of the fields it is given.
+
+    The update expressions are the ones of :class:`NumpyStepper` applied to a
+    band of rows, so the union of the slabs reproduces the serial engine bit
+    for bit. Rows ``start - 1`` and ``stop`` are only read, and only when the
+    slab does not touch the matching grid boundary.
+
+    Args:
+        coefficients (UpdateCoefficients): Coefficients with the same row indexing as the stepped fields.
+        start (int): First owned row.
+        stop (int): One past the last owned row.
+        lower_boundary (bool): Whether row `start` is the first row of the grid.
+        upper_boundary (bool): Whether row `stop - 1` is the last row of the grid.
+    """
+
+    def __init__(self, coefficients: 'UpdateCoefficients', start: int, stop: int, lower_boundary: bool, upper_boundary: bool):
+        self.coefficients = coefficients
+        n_y = coefficients.shape[-1]
+
+        self.rows = slice(start, stop)
+        self.hy_rows = slice(start, stop - 1 if upper_boundary else stop)
+        self.ez_rows = slice(start + 1 if lower_boundary else start, stop - 1 if upper_boundary else stop)
+
+        n_rows = stop - start
+        n_hy_rows = self.hy_rows.stop - self.hy_rows.start
+        n_ez_rows = max(self.ez_rows.stop - self.ez_rows.start, 0)
+
+        dtype = coefficients.dtype
+
+        self.dEz_dy = numpy.empty((n_rows, n_y - 1), dtype=dtype)
+        self.dEz_dx = numpy.empty((n_hy_rows, n_y), dtype=dtype)
+        self.dHy_dx = numpy.empty((n_ez_rows, n_y - 2), dtype=dtype)
+        self.dHx_dy = numpy.empty((n_ez_rows, n_y - 2), dtype=dtype)
+
+        self.Db_x = coefficients.Db_x[self.rows, :-1]
+        self.Db_y = coefficients.Db_y[self.hy_rows, :]
+        self.Cb_x = coefficients.Cb_x[self.ez_rows, 1:-1]
+        self.Cb_y = coefficients.Cb_y[self.ez_rows, 1:-1]
+        self.Ca = coefficients.Ca[self.rows]
+
+    def update_magnetic(self, Ez: numpy.ndarray, Hx: numpy.ndarray, Hy: numpy.ndarray) -> NoReturn:
+        rows, hy_rows = self.rows, self.hy_rows
+
+        numpy.subtract(Ez[rows, 1:], Ez[rows, :-1], out=self.dEz_dy)
+        numpy.multiply(self.Db_x, self.dEz_dy, out=self.dEz_dy)
+        Hx_view = Hx[rows, :-1]
+        numpy.subtract(Hx_view, self.dEz_dy, out=Hx_view)
+
+        next_rows = slice(hy_rows.start + 1, hy_rows.stop + 1)
+        numpy.subtract(Ez[next_rows, :], Ez[hy_rows, :], out=self.dEz_dx)
+        numpy.multiply(self.Db_y, self.dEz_dx, out=self.dEz_dx)
+        Hy_view = Hy[hy_rows, :]
+        numpy.add(Hy_view, self.dEz_dx, out=Hy_view)
+
+    def update_electric(self, Ez: numpy.ndarray, Hx: numpy.ndarray, Hy: numpy.ndarray) -> NoReturn:
+        ez_rows = self.ez_rows
+        previous_rows = slice(ez_rows.start - 1, ez_rows.stop - 1)
+
+        numpy.subtract(Hy[ez_rows, 1:-1], Hy[previous_rows, 1:-1], out=self.dHy_dx)
+        numpy.multiply(self.Cb_x, self.dHy_dx, out=self.dHy_dx)
+
+        numpy.subtract(Hx[ez_rows, 1:-1], Hx[ez_rows, :-2], out=self.dHx_dy)
+        numpy.multiply(self.Cb_y, self.dHx_dy, out=self.dHx_dy)
+
+        numpy.subtract(self.dHy_dx, self.dHx_dy, out=self.dHy_dx)
+        Ez_view = Ez[ez_rows, 1:-1]
+        numpy.add(Ez_view, self.dHy_dx, out=Ez_view)
+
+    def apply_damping(self, Ez: numpy.ndarray) -> NoReturn:
+        Ez_view = Ez[self.rows]
+        numpy.multiply(Ez_view, self.Ca, out=Ez_view)
+
+
+class ThreadedStepper:
+    """
+    Shared-memory slab decomposition of the leapfrog over a pool of worker threads.
+
+    Each worker owns one slab of rows of the global fields and runs its
+    :class:`SlabStepper` on it. numpy releases the GIL inside the element-wise
+    kernels so the slabs are updated concurrently. The halo exchange is
+    implicit: every half step ends with all the workers joined, after which
+    the interface rows written by a slab are visible to its neighbours.
+
+    The stepper is a context manager shutting its thread pool down on exit,
+    Experiment.run_fdtd uses it that way so no worker outlives a failed run.
+
+    Args:
+        coefficients (UpdateCoefficients): The precomputed per-cell update coefficients.
+        shape (tuple): Shape of the stepped fields, must be the grid shape.
+        n_workers (int): Number of worker threads, default is the number of available cores.
+    """
+
+    def __init__(self, coefficients: 'UpdateCoefficients', shape: Optional[Tuple[int, ...]] = None, n_workers: Optional[int] = None):
+        if shape is not None and tuple(shape) != coefficients.shape:
+            raise ValueError("The threaded backend only steps a single field of the grid shape.")
+
+        self.coefficients = coefficients
+        self.shape = coefficients.shape
+        self.n_workers = n_workers or get_available_cores()
+
+        self.partition = SlabPartition(n_x=self.shape[0], n_slabs=self.n_workers)
+        self.slabs = self.get_slab_steppers()
+        self.executor = ThreadPoolExecutor(max_workers=len(self.partition))
+
+    def get_slab_steppers(self) -> List[SlabStepper]:
+        slabs = []
+        for index in range(len(self.partition)):
+            start, stop = self.partition.get_rows(index)
+            slabs.append(
+                SlabStepper(
+                    coefficients=self.coefficients,
+                    start=start,
+                    stop=stop,
+                    lower_boundary=start == 0,
+                    upper_boundary=stop == self.shape[0]
+                )
+            )
+
+        return slabs
+
+    def run(self, method: str, *fields) -> NoReturn:
+        """Run one phase of the step on every slab and wait for all of them."""
+        futures = [self.executor.submit(getattr(slab, method), *fields) for slab in self.slabs]
+        for future in futures:
+            future.result()
+
+    def update_magnetic(self, Ez: numpy.ndarray, Hx: numpy.ndarray, Hy: numpy.ndarray) -> NoReturn:
+        self.run('update_magnetic', Ez, Hx, Hy)
+
+    def update_electric(self, Ez: numpy.ndarray, Hx: numpy.ndarray, Hy: numpy.ndarray) -> NoReturn:
+        self.run('update_electric', Ez, Hx, Hy)
+
+    def apply_damping(self, Ez: numpy.ndarray) -> NoReturn:
+        if self.coefficients.has_damping:
+            self.run('apply_damping', Ez)
+
+    def close(self) -> NoReturn:
+        """Shut the worker threads down, the stepper cannot be used afterwards."""
+        self.executor.shutdown(wait=True)
+
+    def __enter__(self) -> 'ThreadedStepper':
+        return self
+
+    def __exit__(self, *exception) -> NoReturn:
+        self.close()
+
+# -
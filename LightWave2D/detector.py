@@ -1,15 +1,18 @@
 #!/usr/bin/env python
 # -*- coding: utf-8 -*-
 
-from typing import Tuple, Union, NoReturn
+from typing import Tuple, Union, NoReturn, Optional, List
 from dataclasses import field
 import numpy
 from LightWave2D.grid import Grid
+from LightWave2D.physics import Physics
+from LightWave2D.utils import bresenham_line
+from LightWave2D.harmonic_inversion import HarmonicInversion
 import shapely.geometry as geo
 from matplotlib.path import Path
 from pydantic.dataclasses import dataclass
 from matplotlib.collections import PatchCollection
-from matplotlib.patches import PathPatch
+from matplotlib.patches import PathPatch, Rectangle
 import matplotlib.pyplot as plt
 import matplotlib
 
@@ -114,6 +117,8 @@ class PointDetector(BaseDetector):
 
         self.data = numpy.zeros(self.grid.n_steps)
 
+        self.flat_index = numpy.ravel_multi_index(([self.p0.x_index], [self.p0.y_index]), self.grid.shape)
+
     def update_data(self, field: numpy.ndarray) -> NoReturn:
         """
         Update the detector data based on the provided field values.
@@ -126,6 +131,16 @@ class PointDetector(BaseDetector):
         else:
             self.data = abs(field[:, self.p0.x_index, self.p0.y_index])
 
+    def set_data(self, trace: numpy.ndarray) -> NoReturn:
+        """
+        Store the time trace sampled at the detector position during the run.
+
+        Parameters:
+            trace (numpy.ndarray): The sampled values of shape (n_steps, 1).
+        """
+        trace = trace[:, 0]
+        self.data = trace if self.coherent else abs(trace)
+
     def plot_data(self) -> NoReturn:
         """
         Plot the detector data over time.
@@ -134,11 +149,24 @@ class PointDetector(BaseDetector):
             SceneList: A scene list containing the plot.
         """
         figure, ax = plt.subplots(1, 1, figsize=(8, 4))
-        ax.plot(self.grid.time_stamp, self.data)
+        ax.plot(self.grid.time_stamp[:self.data.shape[0]], self.data)
         ax.set_ylabel('Amplitude')
         ax.set_xlabel('Time [seconds]')
         figure.show()
 
+    def get_resonances(self, start_time: float = 0, **kwargs) -> HarmonicInversion:
+        """
+        Resonance frequencies, decay rates and quality factors of the trace by harmonic inversion.
+
+        Args:
+            start_time (float): Time from which the trace is used, after the excitation [s].
+            kwargs: Other arguments of HarmonicInversion (n_modes, tolerance, stride, wavelength_range).
+
+        Returns:
+            HarmonicInversion: The resonances found in the trace.
+        """
+        return HarmonicInversion.from_detector(self, start_time=start_time, **kwargs)
+
     def add_to_ax(self, ax: plt.axis) -> NoReturn:
         """
         Add the scatterer to the provided axis as a circle.
@@ -153,4 +181,330 @@ class PointDetector(BaseDetector):
             label='detector'
         )
 
+
+@dataclass(kw_only=True, config=config_dict)
+class FrequencyMonitor(BaseDetector):
+    """
+    Running discrete Fourier transform of Ez at a set of wavelengths.
+
+    At every time step the monitor accumulates ``Ez * exp(-i omega t) * dt``
+    over its cells, so the complex steady-state field maps are available at
+    the end of the run with a memory footprint independent of n_steps.
+
+    The monitored cells are a single point (`position`), a line between
+    `point_0` and `point_1`, or a rectangular `region` given by two corners.
+    Without any of those the whole grid is monitored.
+
+    Attributes:
+        wavelength (float | List[float] | numpy.ndarray): Wavelengths at which the field is transformed.
+        position (Tuple[float | str, float | str]): Position of a point monitor.
+        point_0 (Tuple[float | str, float | str]): Starting position of a line monitor.
+        point_1 (Tuple[float | str, float | str]): Ending position of a line monitor.
+        region (Tuple): Two corners ((x0, y0), (x1, y1)) of a region monitor.
+        data (numpy.ndarray): Complex field of shape (n_wavelength, *spatial_shape) after the run.
+    """
+    wavelength: Union[float, List[float], numpy.ndarray]
+    position: Optional[Tuple[float | str, float | str]] = None
+    point_0: Optional[Tuple[float | str, float | str]] = None
+    point_1: Optional[Tuple[float | str, float | str]] = None
+    region: Optional[Tuple[Tuple[float | str, float | str], Tuple[float | str, float | str]]] = None
+    facecolor: str = 'purple'
+    edgecolor: str = 'purple'
+    alpha: float = 0.3
+    data: numpy.ndarray = field(init=False)
+
+    def __post_init__(self):
+        self.wavelength = numpy.atleast_1d(self.wavelength).astype(float)
+        self.frequency = Physics.c / self.wavelength
+        self.omega = 2 * numpy.pi * self.frequency
+
+        if self.position is not None:
+            self.p0 = self.grid.get_coordinate(x=self.position[0], y=self.position[1])
+            rows, cols = numpy.array([self.p0.x_index]), numpy.array([self.p0.y_index])
+            self.spatial_shape = ()
+
+        elif self.point_0 is not None and self.point_1 is not None:
+            self.p0 = self.grid.get_coordinate(x=self.point_0[0], y=self.point_0[1])
+            self.p1 = self.grid.get_coordinate(x=self.point_1[0], y=self.point_1[1])
+            rows, cols = bresenham_line(x0=self.p0.x_index, y0=self.p0.y_index, x1=self.p1.x_index, y1=self.p1.y_index)
+            self.spatial_shape = (rows.size,)
+
+        else:
+            (x0, y0), (x1, y1) = self.region if self.region is not None else (('left', 'bottom'), ('right', 'top'))
+            self.p0 = self.grid.get_coordinate(x=x0, y=y0)
+            self.p1 = self.grid.get_coordinate(x=x1, y=y1)
+            x_start, x_stop = sorted([self.p0.x_index, self.p1.x_index])
+            y_start, y_stop = sorted([self.p0.y_index, self.p1.y_index])
+            self.x_stamp = self.grid.x_stamp[x_start:x_stop + 1]
+            self.y_stamp = self.grid.y_stamp[y_start:y_stop + 1]
+            rows, cols = numpy.meshgrid(numpy.arange(x_start, x_stop + 1), numpy.arange(y_start, y_stop + 1), indexing='ij')
+            self.spatial_shape = rows.shape
+
+        self.rows, self.cols = numpy.ravel(rows), numpy.ravel(cols)
+        self.flat_index = numpy.ravel_multi_index((self.rows, self.cols), self.grid.shape)
+
+        self.data = numpy.zeros((self.wavelength.size, *self.spatial_shape), dtype=complex)
+
+    def initialize(self, dtype: numpy.dtype = numpy.float64, n_cells: Optional[int] = None) -> NoReturn:
+        """
+        Reset the running transform before a simulation.
+
+        Args:
+            dtype (numpy.dtype): Floating point type of the accumulated sums, the phases are always computed in double precision.
+            n_cells (int): Number of transformed cells, default is all the cells of the monitor (fewer for one slab of a domain decomposition).
+        """
+        n_cells = self.flat_index.size if n_cells is None else n_cells
+
+        self.real = numpy.zeros((self.wavelength.size, n_cells), dtype=dtype)
+        self.imag = numpy.zeros((self.wavelength.size, n_cells), dtype=dtype)
+        self.product = numpy.empty((self.wavelength.size, n_cells), dtype=dtype)
+        self.phase = numpy.empty(self.wavelength.size)
+        self.cos_phase = numpy.empty(self.wavelength.size)
+        self.sin_phase = numpy.empty(self.wavelength.size)
+
+    def accumulate(self, iteration: int, values: numpy.ndarray) -> NoReturn:
+        """
+        Add the contribution of one time step to the running transform.
+
+        Parameters:
+            iteration (int): The current time step index.
+            values (numpy.ndarray): Ez sampled at the monitor cells.
+        """
+        numpy.multiply(self.omega, self.grid.time_stamp[iteration], out=self.phase)
+        numpy.cos(self.phase, out=self.cos_phase)
+        numpy.sin(self.phase, out=self.sin_phase)
+
+        numpy.multiply.outer(self.cos_phase, values, out=self.product)
+        numpy.add(self.real, self.product, out=self.real)
+
+        numpy.multiply.outer(self.sin_phase, values, out=self.product)
+        numpy.subtract(self.imag, self.product, out=self.imag)
+
+    def finalize(self) -> NoReturn:
+        """
+        Convert the accumulated sums into the complex field maps.
+        """
+        field = (self.real + 1j * self.imag) * self.grid.dt
+        self.data = field.reshape((self.wavelength.size, *self.spatial_shape))
+
+    def add_to_ax(self, ax: plt.axis) -> NoReturn:
+        """
+        Add the monitor to the provided axis.
+
+        Args:
+            ax (Axis): The axis to which the monitor will be added.
+        """
+        if self.position is not None:
+            ax.scatter(self.p0.x, self.p0.y, color=self.facecolor, label='monitor')
+
+        elif len(self.spatial_shape) == 1:
+            ax.plot([self.p0.x, self.p1.x], [self.p0.y, self.p1.y], color=self.facecolor, label='monitor')
+
+        else:
+            rectangle = Rectangle(
+                (self.x_stamp[0], self.y_stamp[0]),
+                self.x_stamp[-1] - self.x_stamp[0],
+                self.y_stamp[-1] - self.y_stamp[0],
+                facecolor=self.facecolor,
+                edgecolor=self.edgecolor,
+                alpha=self.alpha,
+                label='monitor'
+            )
+            ax.add_patch(rectangle)
+
+    def plot_data(self, wavelength_index: int = 0) -> NoReturn:
+        """
+        Plot the magnitude of the transformed field.
+
+        Args:
+            wavelength_index (int): Index of the wavelength to display for line and region monitors.
+        """
+        figure, ax = plt.subplots(1, 1, figsize=(8, 4))
+
+        if self.position is not None:
+            ax.plot(self.wavelength, abs(self.data), 'o-')
+            ax.set_xlabel('Wavelength [m]')
+            ax.set_ylabel('|Ez|')
+
+        elif len(self.spatial_shape) == 1:
+            ax.plot(abs(self.data[wavelength_index]))
+            ax.set_xlabel('Cell along the line')
+            ax.set_ylabel('|Ez|')
+
+        else:
+            image = ax.pcolormesh(self.x_stamp, self.y_stamp, abs(self.data[wavelength_index]).T)
+            ax.set_aspect('equal')
+            ax.set_xlabel(r'x position [$\mu$m]')
+            ax.set_ylabel(r'y position [$\mu$m]')
+            plt.colorbar(image, ax=ax, label='|Ez|')
+
+        ax.set_title(f'Frequency monitor, wavelength: {self.wavelength[wavelength_index]:.3e} m')
+        figure.show()
+
+
+class DetectorBank:
+    """
+    Samples every registered detector inside the time loop with a single
+    vectorized gather.
+
+    Each detector exposes the flat indices of the cells it reads
+    (`flat_index`). The bank concatenates them once and, at every time step,
+    takes all the values with one gather. Traced detectors copy their values
+    into one preallocated (n_steps, n_traced) buffer, so the memory scales
+    with the number of probed cells rather than with the grid, while
+    frequency monitors fold theirs into a running transform. At the end of
+    the run each detector receives its own data.
+
+    When the sampled field only holds a band of rows of the grid (one slab of
+    a domain decomposition), only the cells of the owned rows are sampled,
+    traced and transformed. `get_local_parts` tells where the columns of the
+    local accumulators go in the serial ones, so that the slabs can be
+    gathered and handed over with `set_accumulators`.
+
+    Detectors of several variants stacked in one (B, n_x, n_y) field are
+    sampled by a single bank with per-detector `index_offsets`, as in
+    SourceTable.
+
+    Args:
+        grid (Grid): The grid of the simulation mesh.
+        detectors (list): The detectors to sample.
+        owned_rows (tuple): Grid rows (start, stop) sampled by this bank, default is the whole grid.
+        row_offset (int): Grid row of the first row of the sampled field (default is 0).
+        dtype (numpy.dtype): Floating point type of the sampled values and traces (default is float64).
+        monitor_dtype (numpy.dtype): Floating point type of the running transforms, default is `dtype`.
+        index_offsets (list): Offset added to the flat indices of each detector, for a stacked field (default is none).
+    """
+
+    def __init__(
+            self,
+            grid: Grid,
+            detectors: list,
+            owned_rows: Optional[Tuple[int, int]] = None,
+            row_offset: int = 0,
+            dtype: numpy.dtype = numpy.float64,
+            monitor_dtype: Optional[numpy.dtype] = None,
+            index_offsets: Optional[list] = None):
+        self.grid = grid
+        self.traced = [detector for detector in detectors if not isinstance(detector, FrequencyMonitor)]
+        self.monitors = [detector for detector in detectors if isinstance(detector, FrequencyMonitor)]
+
+        if index_offsets is None:
+            index_offsets = [0] * len(detectors)
+        offset_of = {id(detector): offset for detector, offset in zip(detectors, index_offsets)}
+
+        ordered = [*self.traced, *self.monitors]
+        sizes = [detector.flat_index.size for detector in ordered]
+        offsets = numpy.cumsum([0, *sizes])
+        slices = [slice(start, stop) for start, stop in zip(offsets[:-1], offsets[1:])]
+
+        self.traced_slices = slices[:len(self.traced)]
+        self.monitor_slices = slices[len(self.traced):]
+        self.n_traced = int(offsets[len(self.traced)])
+
+        self.index = numpy.concatenate([detector.flat_index + offset_of[id(detector)] for detector in ordered]).astype(numpy.intp) if ordered else numpy.arange(0)
+
+        owned = numpy.ones(self.index.size, dtype=bool)
+        if owned_rows is not None:
+            rows = self.index // grid.n_y
+            owned = (rows >= owned_rows[0]) & (rows < owned_rows[1])
+            self.index = self.index[owned] - row_offset * grid.n_y
+
+        # Position of every sampled cell in the ordering of the serial bank.
+        self.owned_position = numpy.flatnonzero(owned)
+        local_offsets = numpy.searchsorted(self.owned_position, offsets)
+
+        self.n_traced_local = int(local_offsets[len(self.traced)])
+        self.local_monitor_slices = [
+            slice(start, stop) for start, stop in zip(local_offsets[len(self.traced):-1], local_offsets[len(self.traced) + 1:])
+        ]
+
+        self.values = numpy.zeros(self.index.size, dtype=dtype)
+        self.buffer = numpy.zeros((grid.n_steps, self.n_traced_local), dtype=dtype)
+
+        for monitor, local_slice in zip(self.monitors, self.local_monitor_slices):
+            monitor.initialize(dtype=dtype if monitor_dtype is None else monitor_dtype, n_cells=local_slice.stop - local_slice.start)
+
+    def sample(self, iteration: int, field: numpy.ndarray) -> NoReturn:
+        """
+        Gather the probed cells of the field for one time step.
+
+        Parameters:
+            iteration (int): The current time step index.
+            field (numpy.ndarray): The C-contiguous Ez field at that time step.
+        """
+        if not self.index.size:
+            return
+
+        numpy.take(field.reshape(-1), self.index, out=self.values, mode='clip')
+
+        self.store(iteration, self.values)
+
+    def store(self, iteration: int, values: numpy.ndarray) -> NoReturn:
+        """
+        Hand the values of the probed cells at one time step to the traces and monitors.
+
+        Parameters:
+            iteration (int): The current time step index.
+            values (numpy.ndarray): Ez at the cells of `index`, in the same order.
+        """
+        self.buffer[iteration] = values[:self.n_traced_local]
+
+        for monitor, probe_slice in zip(self.monitors, self.local_monitor_slices):
+            monitor.accumulate(iteration, values[probe_slice])
+
+    def get_accumulators(self) -> list:
+        """
+        Arrays holding the sampled state, i.e. the trace buffer and the running transforms of the monitors.
+
+        Returns:
+            list: The arrays, in a fixed order.
+        """
+        accumulators = [self.buffer]
+        for monitor in self.monitors:
+            accumulators += [monitor.real, monitor.imag]
+
+        return accumulators
+
+    def get_local_parts(self) -> list:
+        """
+        Where the columns of the accumulators of this bank go in the accumulators of the serial bank.
+
+        Returns:
+            list: (array, column positions, number of serial columns) triplets, in the order of `get_accumulators`.
+        """
+        traced_position = self.owned_position[:self.n_traced_local]
+        parts = [(self.buffer, traced_position, self.n_traced)]
+
+        for monitor, local_slice, global_slice in zip(self.monitors, self.local_monitor_slices, self.monitor_slices):
+            position = self.owned_position[local_slice] - global_slice.start
+            parts += [(monitor.real, position, monitor.flat_index.size), (monitor.imag, position, monitor.flat_index.size)]
+
+        return parts
+
+    def set_accumulators(self, arrays: list) -> NoReturn:
+        """
+        Replace the accumulators by the serial ones, e.g. gathered from all the slabs of a domain decomposition.
+
+        Args:
+            arrays (list): The arrays, in the order of `get_accumulators`.
+        """
+        self.buffer = arrays[0]
+        self.n_traced_local = self.n_traced
+
+        for index, monitor in enumerate(self.monitors):
+            monitor.real, monitor.imag = arrays[1 + 2 * index], arrays[2 + 2 * index]
+
+    def finalize(self, n_steps: Optional[int] = None) -> NoReturn:
+        """
+        Hand the sampled traces and transforms over to their detectors.
+
+        Parameters:
+            n_steps (int): Number of time steps actually run, default is all of them.
+        """
+        for detector, probe_slice in zip(self.traced, self.traced_slices):
+            detector.set_data(self.buffer[:n_steps, probe_slice])
+
+        for monitor in self.monitors:
+            monitor.finalize()
+
 # -
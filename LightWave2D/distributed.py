@@ -0,0 +1,296 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+import sys
+import shutil
+import argparse
+import subprocess
+from typing import NoReturn, Optional, Tuple, List
+import numpy
+from LightWave2D.experiment import Experiment
+from LightWave2D.detector import DetectorBank
+from LightWave2D.decomposition import SlabPartition, SlabStepper
+from LightWave2D.pml import CPML
+from LightWave2D.recording import Recording
+
+
+def get_communicator(comm=None):
+    """
+    Return the given communicator or MPI.COMM_WORLD.
+
+    Raises:
+        ImportError: If mpi4py is not installed.
+    """
+    try:
+        from mpi4py import MPI
+    except ImportError as error:
+        raise ImportError(
+            "The distributed engine requires mpi4py and an MPI implementation, install them with 'pip install mpi4py'."
+        ) from error
+
+    return MPI.COMM_WORLD if comm is None else comm
+
+
+class MPIStepper:
+    """
+    Leapfrog of the band of rows owned by one rank, with the halo exchange between neighbouring ranks.
+
+    The local fields hold the owned rows plus one halo row on each side
+    where a neighbour exists. Before the H update, every rank receives the
+    first owned Ez row of the next rank; before the Ez update, it receives
+    the last owned Hy row of the previous rank. Nothing else crosses ranks.
+
+    Args:
+        coefficients (UpdateCoefficients): The coefficients of the local rows, halo included.
+        partition (SlabPartition): The partition of the grid rows over the ranks.
+        comm (MPI.Comm): The communicator, its rank indexes the partition.
+    """
+
+    def __init__(self, coefficients: 'UpdateCoefficients', partition: SlabPartition, comm):
+        from mpi4py import MPI
+
+        self.coefficients = coefficients
+        self.comm = comm
+        self.rank = comm.Get_rank()
+
+        n_x = partition.n_x
+        start, stop = partition.get_rows(self.rank)
+        self.row_offset, _ = partition.get_halo_rows(self.rank)
+
+        self.has_previous, self.has_next = start > 0, stop < n_x
+        self.previous = self.rank - 1 if self.has_previous else MPI.PROC_NULL
+        self.next = self.rank + 1 if self.has_next else MPI.PROC_NULL
+
+        self.first_row = start - self.row_offset
+        self.last_row = stop - 1 - self.row_offset
+        self.dummy_row = numpy.empty(coefficients.shape[-1], dtype=coefficients.dtype)
+
+        self.slab = SlabStepper(
+            coefficients=coefficients,
+            start=self.first_row,
+            stop=self.last_row + 1,
+            lower_boundary=start == 0,
+            upper_boundary=stop == n_x
+        )
+
+    def exchange_electric(self, Ez: numpy.ndarray) -> NoReturn:
+        """Send the first owned Ez row backward, receive the next rank's one into the upper halo."""
+        halo = Ez[self.last_row + 1] if self.has_next else self.dummy_row
+        self.comm.Sendrecv(sendbuf=Ez[self.first_row], dest=self.previous, recvbuf=halo, source=self.next)
+
+    def exchange_magnetic(self, Hy: numpy.ndarray) -> NoReturn:
+        """Send the last owned Hy row forward, receive the previous rank's one into the lower halo."""
+        halo = Hy[self.first_row - 1] if self.has_previous else self.dummy_row
+        self.comm.Sendrecv(sendbuf=Hy[self.last_row], dest=self.next, recvbuf=halo, source=self.previous)
+
+    def update_magnetic(self, Ez: numpy.ndarray, Hx: numpy.ndarray, Hy: numpy.ndarray) -> NoReturn:
+        self.exchange_electric(Ez)
+        self.slab.update_magnetic(Ez, Hx, Hy)
+
+    def update_electric(self, Ez: numpy.ndarray, Hx: numpy.ndarray, Hy: numpy.ndarray) -> NoReturn:
+        self.exchange_magnetic(Hy)
+        self.slab.update_electric(Ez, Hx, Hy)
+
+    def apply_damping(self, Ez: numpy.ndarray) -> NoReturn:
+        if self.coefficients.has_damping:
+            self.slab.apply_damping(Ez)
+
+
+class DistributedExperiment:
+    """
+    MPI domain decomposition of an Experiment along its rows.
+
+    Every rank runs the same script and builds the same Experiment, which
+    only stores geometry. At run time each rank assembles the coefficients,
+    PML and fields of its band of rows only, so the memory per rank scales
+    as 1 / n_ranks. Detectors and frequency monitors are sampled and
+    transformed on the rank owning their cells only, and gathered onto rank 0
+    at the end of the run, where they hold exactly the data of a serial run.
+
+    Example, run with ``mpirun -n 4 python script.py`` or with :func:`launch`:
+
+        experiment = Experiment(grid=grid)
+        ...
+        DistributedExperiment(experiment=experiment).run_fdtd()
+        if experiment.detectors[0].data is not None:
+            experiment.detectors[0].plot()
+
+    Args:
+        experiment (Experiment): The experiment to run.
+        comm (MPI.Comm): The communicator, default is MPI.COMM_WORLD.
+    """
+
+    def __init__(self, experiment: Experiment, comm=None):
+        self.experiment = experiment
+        self.grid = experiment.grid
+        self.comm = get_communicator(comm)
+        self.rank = self.comm.Get_rank()
+        self.n_ranks = self.comm.Get_size()
+
+        if self.n_ranks > self.grid.n_x:
+            raise ValueError(f"Cannot split {self.grid.n_x} rows over {self.n_ranks} ranks.")
+
+        self.partition = SlabPartition(n_x=self.grid.n_x, n_slabs=self.n_ranks)
+        self.owned_rows = self.partition.get_rows(self.rank)
+        self.local_rows = self.partition.get_halo_rows(self.rank)
+        self.row_offset = self.local_rows[0]
+
+    @property
+    def local_shape(self) -> Tuple[int, int]:
+        start, stop = self.local_rows
+        return stop - start, self.grid.n_y
+
+    def get_local_non_linear_index(self) -> List[tuple]:
+        """
+        Local flat indices of the owned cells of every non-linear component.
+
+        Returns:
+            list: (component, flat_index) pairs.
+        """
+        start, stop = self.owned_rows
+        pairs = []
+        for component in self.experiment.components:
+            if not component.is_non_linear:
+                continue
+
+            rows = component.flat_index // self.grid.n_y
+            owned = (rows >= start) & (rows < stop)
+            pairs.append((component, component.flat_index[owned] - self.row_offset * self.grid.n_y))
+
+        return pairs
+
+    def gather_columns(self, array: numpy.ndarray, position: numpy.ndarray, n_columns: int) -> Optional[numpy.ndarray]:
+        """
+        Gather the columns owned by every rank into one array on rank 0.
+
+        Args:
+            array (numpy.ndarray): The local array of shape (n_rows, n_local_columns).
+            position (numpy.ndarray): Column of every local column in the gathered array.
+            n_columns (int): Number of columns of the gathered array.
+
+        Returns:
+            numpy.ndarray: The array of shape (n_rows, n_columns) on rank 0, None on the other ranks.
+        """
+        send = numpy.ascontiguousarray(array.T)
+        counts = self.comm.gather(send.size, root=0)
+        positions = self.comm.gather(position, root=0)
+
+        if self.rank != 0:
+            self.comm.Gatherv(send, None, root=0)
+            return None
+
+        receive = numpy.empty(sum(counts), dtype=array.dtype)
+        self.comm.Gatherv(send, [receive, counts], root=0)
+
+        gathered = numpy.zeros((array.shape[0], n_columns), dtype=array.dtype)
+        gathered[:, numpy.concatenate(positions)] = receive.reshape(-1, array.shape[0]).T
+
+        return gathered
+
+    def gather_detectors(self, detector_bank: DetectorBank) -> NoReturn:
+        """
+        Gather the traces and transforms of the cells owned by every rank onto rank 0.
+        """
+        arrays = [self.gather_columns(*part) for part in detector_bank.get_local_parts()]
+
+        if self.rank == 0:
+            detector_bank.set_accumulators(arrays)
+
+    def run_fdtd(self) -> NoReturn:
+        """
+        Run the FDTD simulation over all the ranks of the communicator.
+
+        Ez frames are not recorded, the detectors and monitors hold the
+        results on rank 0 and are left empty (None) on the other ranks.
+        """
+        experiment = self.experiment
+
+        if experiment.plane_wave is not None:
+            raise ValueError("The distributed engine does not support plane waves, use Experiment.run_fdtd.")
+
+        coefficients = experiment.get_update_coefficients(rows=self.local_rows)
+        stepper = MPIStepper(coefficients=coefficients, partition=self.partition, comm=self.comm)
+
+        experiment.recording = Recording(every=None)
+        experiment.recording.initialize(grid=self.grid, dtype=experiment.dtype)
+        experiment.Ez_t = experiment.recording.data
+
+        detector_bank = experiment.get_detector_bank(owned_rows=self.owned_rows, row_offset=self.row_offset)
+
+        Ez = numpy.zeros(self.local_shape, dtype=experiment.dtype)
+        Hx = numpy.zeros(self.local_shape, dtype=experiment.dtype)
+        Hy = numpy.zeros(self.local_shape, dtype=experiment.dtype)
+
+        source_table = experiment.get_source_table()
+        source_table.restrict(owned_rows=self.owned_rows, row_offset=self.row_offset, n_y=self.grid.n_y)
+
+        non_linear_components = self.get_local_non_linear_index()
+
+        cpml = experiment.pml if isinstance(experiment.pml, CPML) else None
+        if cpml is not None:
+            cpml.initialize(Ez=Ez, Hx=Hx, Hy=Hy, coefficients=coefficients, owned_rows=self.owned_rows, row_offset=self.row_offset)
+
+        for iteration in range(self.grid.n_steps):
+
+            stepper.update_magnetic(Ez, Hx, Hy)
+
+            if cpml is not None:
+                cpml.update_magnetic()
+
+            stepper.update_electric(Ez, Hx, Hy)
+
+            if cpml is not None:
+                cpml.update_electric()
+
+            for component, flat_index in non_linear_components:
+                component.add_non_linear_effect_to_field(Ez, flat_index=flat_index)
+
+            stepper.apply_damping(Ez)
+
+            source_table.inject(Ez, iteration)
+
+            detector_bank.sample(iteration, Ez)
+
+        experiment.n_steps_run, experiment.stop_reason = self.grid.n_steps, None
+
+        self.gather_detectors(detector_bank)
+
+        if self.rank == 0:
+            detector_bank.finalize()
+        else:
+            for detector in experiment.detectors:
+                detector.data = None
+
+
+def launch(script: str, n_ranks: int, arguments: Optional[List[str]] = None, mpirun: str = 'mpirun') -> subprocess.CompletedProcess:
+    """
+    Run a script under MPI on the local machine.
+
+    Args:
+        script (str): Path of the Python script building and running a DistributedExperiment.
+        n_ranks (int): Number of MPI processes.
+        arguments (list): Extra command line arguments passed to the script.
+        mpirun (str): MPI launcher executable, default is 'mpirun'.
+
+    Returns:
+        subprocess.CompletedProcess: The completed launcher process.
+    """
+    if shutil.which(mpirun) is None:
+        raise FileNotFoundError(f"MPI launcher '{mpirun}' not found, install an MPI implementation (e.g. OpenMPI or MPICH).")
+
+    command = [mpirun, '-n', str(n_ranks), sys.executable, script, *(arguments or [])]
+
+    return subprocess.run(command, check=True)
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Run a LightWave2D script over several local MPI processes.')
+    parser.add_argument('-n', '--n-ranks', type=int, required=True, help='Number of MPI processes.')
+    parser.add_argument('--mpirun', default='mpirun', help='MPI launcher executable.')
+    parser.add_argument('script', help='Python script to run.')
+    parser.add_argument('arguments', nargs=argparse.REMAINDER, help='Arguments passed to the script.')
+
+    options = parser.parse_args()
+    launch(script=options.script, n_ranks=options.n_ranks, arguments=options.arguments, mpirun=options.mpirun)
+
+# -
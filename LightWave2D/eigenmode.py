@@ -0,0 +1,153 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+from typing import NoReturn, Optional
+import numpy
+import scipy.sparse
+import scipy.sparse.linalg
+from LightWave2D.physics import Physics
+from LightWave2D.experiment import Experiment
+from LightWave2D.frequency_domain import StretchedLaplacian
+import matplotlib.pyplot as plt
+
+
+class EigenmodeSolver:
+    """
+    Resonant modes of an experiment near a target wavelength, by shift-invert sparse eigensolving.
+
+    The modes are the source-free solutions of the FDFD Helmholtz equation,
+
+        -1 / (mu_0 epsilon) L Ez = omega**2 Ez,
+
+    with the StretchedLaplacian L of FrequencyDomainExperiment, so the
+    geometry, the subpixel smoothing and the PML are the ones of the time
+    and frequency domain solvers. ARPACK in shift-invert mode around the
+    target omega**2 returns the eigenvalues closest to it after a single
+    sparse LU factorization, without choosing source positions nor run
+    lengths.
+
+    The eigenfrequencies are complex with the exp(i omega t) convention:
+    a mode losing energy through the PML has Im(omega) > 0 and
+    ``Q = Re(omega) / (2 Im(omega))``. The PML stretch depends on the
+    frequency and is evaluated at the target, which is accurate for modes
+    close to it; `n_refine` re-solves every mode with the stretch at its own
+    frequency. Modes trapped in the PML itself are spurious and show a low Q.
+
+    Args:
+        experiment (Experiment): The experiment giving the geometry, its sources and detectors are ignored.
+        wavelength (float): The target vacuum wavelength.
+        n_modes (int): Number of modes computed (default is 5).
+        n_refine (int): Number of re-solves with the stretch at the frequency of each mode (default is 0).
+    """
+
+    def __init__(self, experiment: Experiment, wavelength: float, n_modes: int = 5, n_refine: int = 0):
+        if any(component.is_non_linear for component in experiment.components):
+            raise ValueError("The eigenmode solver is linear, remove the non-linear components.")
+
+        self.experiment = experiment
+        self.grid = experiment.grid
+        self.wavelength = wavelength
+        self.omega = 2 * numpy.pi * Physics.c / wavelength
+        self.n_modes = n_modes
+        self.n_refine = n_refine
+
+        self.epsilon = experiment.get_epsilon()
+        self.laplacian = StretchedLaplacian(grid=self.grid, pml=experiment.pml)
+
+        self.eigenfrequency = None
+        self.modes = None
+
+    def get_eigen_operator(self) -> scipy.sparse.csc_matrix:
+        """
+        Operator -1 / (mu_0 epsilon) L whose eigenvalues are omega**2, with the stretch at the current `omega`.
+
+        Returns:
+            scipy.sparse.csc_matrix: Matrix of shape (n_x n_y, n_x n_y).
+        """
+        inverse_mass = scipy.sparse.diags(1 / (Physics.mu_0 * self.epsilon.ravel()))
+
+        return (-inverse_mass @ self.laplacian.get_matrix(omega=self.omega)).tocsc()
+
+    def get_eigenpairs(self, shift: complex, n_modes: int) -> tuple:
+        """
+        Eigenfrequencies and flattened modes closest to an angular frequency.
+
+        Args:
+            shift (complex): The angular frequency around which the modes are searched, its real part sets the stretch.
+            n_modes (int): Number of modes.
+
+        Returns:
+            tuple: The complex eigenfrequencies and the modes as columns.
+        """
+        self.omega = numpy.real(shift)
+
+        eigenvalues, vectors = scipy.sparse.linalg.eigs(self.get_eigen_operator(), k=n_modes, sigma=shift**2, which='LM')
+
+        return numpy.sqrt(eigenvalues.astype(complex)), vectors
+
+    def solve(self, n_modes: Optional[int] = None) -> numpy.ndarray:
+        """
+        Compute the modes closest to the target wavelength.
+
+        Args:
+            n_modes (int): Number of modes, default is `n_modes` of the solver.
+
+        Returns:
+            numpy.ndarray: The complex eigenfrequencies omega [rad/s], sorted by distance to the target.
+                The mode profiles are stored in `modes`, of shape (n_modes, n_x, n_y), normalized to a unit peak.
+        """
+        n_modes = self.n_modes if n_modes is None else n_modes
+        target = 2 * numpy.pi * Physics.c / self.wavelength
+
+        eigenfrequency, vectors = self.get_eigenpairs(shift=target, n_modes=n_modes)
+
+        for _ in range(self.n_refine):
+            for index, omega in enumerate(eigenfrequency):
+                refined, refined_vectors = self.get_eigenpairs(shift=omega, n_modes=1)
+                eigenfrequency[index], vectors[:, index] = refined[0], refined_vectors[:, 0]
+
+        self.omega = target
+
+        order = numpy.argsort(abs(eigenfrequency - target))
+        eigenfrequency, vectors = eigenfrequency[order], vectors[:, order]
+
+        peaks = vectors[abs(vectors).argmax(axis=0), numpy.arange(n_modes)]
+        self.modes = (vectors / peaks).T.reshape(n_modes, *self.grid.shape)
+        self.eigenfrequency = eigenfrequency
+
+        return eigenfrequency
+
+    @property
+    def mode_wavelength(self) -> numpy.ndarray:
+        """
+        Vacuum wavelengths of the modes [m].
+        """
+        return 2 * numpy.pi * Physics.c / self.eigenfrequency.real
+
+    @property
+    def quality_factor(self) -> numpy.ndarray:
+        """
+        Quality factors Re(omega) / (2 Im(omega)) of the modes.
+        """
+        return self.eigenfrequency.real / (2 * self.eigenfrequency.imag)
+
+    def plot_mode(self, index: int = 0) -> NoReturn:
+        """
+        Plot the magnitude of a mode.
+
+        Args:
+            index (int): Index of the mode, sorted by distance to the target (default is 0).
+        """
+        assert self.modes is not None, "No mode computed, call solve first."
+
+        figure, ax = self.experiment.get_figure_ax()
+        image = ax.pcolormesh(self.grid.x_stamp, self.grid.y_stamp, abs(self.modes[index]).T, cmap='viridis')
+        plt.colorbar(image, ax=ax, label='|Ez|')
+
+        for component in self.experiment.components:
+            component.add_to_ax(ax)
+
+        ax.set_title(f'Mode {index}, wavelength: {self.mode_wavelength[index]:.4e} m, Q: {self.quality_factor[index]:.3e}')
+        plt.show()
+
+# -
@@ -2,14 +2,21 @@
 # -*- coding: utf-8 -*-
 
 
-from typing import Tuple, NoReturn, Optional, Union
+from typing import Tuple, NoReturn, Optional, Union, Literal
+import warnings
 import numpy
 from LightWave2D.physics import Physics
 from LightWave2D.grid import Grid
 from LightWave2D.components import Circle, Square, Ellipse, Triangle, Lense, Grating, RingResonator
-from LightWave2D.source import PointSource, LineSource, Impulsion
-from LightWave2D.detector import PointDetector
-from LightWave2D.pml import PML
+from LightWave2D.source import PointSource, LineSource, Impulsion, SourceTable
+from LightWave2D.detector import PointDetector, FrequencyMonitor, DetectorBank
+from LightWave2D.pml import PML, CPML
+from LightWave2D.recording import Recording, parse_recording
+from LightWave2D.stepper import UpdateCoefficients, NumpyStepper, steppers
+from LightWave2D.tiling import TiledEngine
+from LightWave2D.checkpoint import Checkpoint
+from LightWave2D.stopping import FieldDecay, MonitorConvergence
+from LightWave2D.tfsf import PlaneWave
 from MPSPlots import colormaps
 import matplotlib.animation as animation
 from pydantic.dataclasses import dataclass
@@ -30,14 +37,27 @@ class Experiment:
 
     grid: Grid
     """The grid of the simulation mesh."""
+    precision: Literal['float64', 'float32'] = 'float64'
+    """Floating point type of the fields, update coefficients, recorded frames and detector traces."""
+    monitor_precision: Optional[Literal['float64', 'float32']] = None
+    """Floating point type of the frequency monitor sums, default is `precision`. 'float64' keeps float32 runs from losing the small late contributions."""
+    subpixel_smoothing: bool = False
+    """Whether the cells cut by a component boundary get the area-weighted average of the permittivities instead of a staircase."""
+    subpixel_samples: int = 8
+    """Number of sub-samples per cell side used to measure the covered area when `subpixel_smoothing` is on."""
 
     def __post_init__(self):
+        self.dtype = numpy.dtype(self.precision)
+        self.monitor_dtype = self.dtype if self.monitor_precision is None else numpy.dtype(self.monitor_precision)
         self.sources = []
         self.components = []
         self.detectors = []
-        self.Ez_t = numpy.zeros((self.grid.n_steps, *self.grid.shape))
-        self.epsilon = numpy.ones(self.grid.shape) * Physics.epsilon_0
+        self.recording = None
+        self.Ez_t = None
+        self.n_steps_run = None
+        self.stop_reason = None
         self.pml = None
+        self.plane_wave = None
 
     def get_gradient(self, field: numpy.ndarray, axis: str) -> numpy.ndarray:
         """
@@ -78,6 +98,9 @@ class Experiment:
         if self.pml:
             self.pml.add_to_ax(ax)
 
+        if self.plane_wave:
+            self.plane_wave.add_to_ax(ax)
+
         for component in [*self.components, *self.sources, *self.detectors]:
             component.add_to_ax(ax)
 
@@ -115,6 +138,16 @@ class Experiment:
         self.pml = PML(grid=self.grid, **kwargs)
         return self.pml
 
+    def add_cpml(self, **kwargs) -> CPML:
+        """Add a convolutional PML, with auxiliary storage on the boundary slabs only, to the simulation."""
+        self.pml = CPML(grid=self.grid, **kwargs)
+        return self.pml
+
+    def add_plane_wave(self, **kwargs) -> PlaneWave:
+        """Add a plane wave travelling along +x, injected through a total-field / scattered-field rectangle."""
+        self.plane_wave = PlaneWave(grid=self.grid, **kwargs)
+        return self.plane_wave
+
     @add_to_component
     def add_circle(self, **kwargs) -> Circle:
         """
@@ -193,82 +226,395 @@ class Experiment:
         """
         return PointDetector(grid=self.grid, **kwargs)
 
-    def get_sigma(self) -> Tuple[numpy.ndarray, numpy.ndarray]:
+    @add_to_detector
+    def add_frequency_monitor(self, **kwargs) -> FrequencyMonitor:
+        """
+        Method to add a FrequencyMonitor (running DFT over a point, a line or a region) to the simulation.
+        """
+        return FrequencyMonitor(grid=self.grid, **kwargs)
+
+    def get_sigma(self, rows: Optional[Tuple[int, int]] = None) -> Tuple[numpy.ndarray, numpy.ndarray]:
         """
         Retrieve the sigma values for the PML.
 
+        Args:
+            rows (tuple): Optional (start, stop) band of grid rows to restrict the arrays to, default is the whole grid.
+
         Returns:
-            tuple: Sigma values for x and y directions.
+            tuple: Sigma values for x and y directions, zero for a CPML which is applied on its own slabs.
         """
-        if self.pml is not None:
-            sigma_x, sigma_y = self.pml.sigma_x, self.pml.sigma_y
+        start, stop = (0, self.grid.n_x) if rows is None else rows
+
+        if isinstance(self.pml, PML):
+            sigma_x, sigma_y = self.pml.sigma_x[start:stop], self.pml.sigma_y[start:stop]
         else:
-            sigma_x = sigma_y = numpy.zeros(self.grid.shape)
+            sigma_x = sigma_y = numpy.zeros((stop - start, self.grid.n_y))
         return sigma_x, sigma_y
 
-    def get_epsilon(self) -> numpy.ndarray:
+    def get_epsilon(self, rows: Optional[Tuple[int, int]] = None) -> numpy.ndarray:
         """
         Construct the epsilon mesh with contributions from all components.
 
+        Each component paints its relative permittivity over its own sparse
+        patch on a vacuum background, later components on top of earlier ones.
+        With `subpixel_smoothing`, the cells cut by a boundary are given the
+        mean permittivity weighted by the area covered by each material. Ez is
+        parallel to every interface in this TMz scheme, for which the
+        anisotropic subpixel average reduces to this arithmetic mean. It
+        removes the first-order staircasing error, e.g. on the resonance
+        wavelengths of a RingResonator, so coarser grids reach the same accuracy.
+
+        Args:
+            rows (tuple): Optional (start, stop) band of grid rows to build the mesh for, default is the whole grid.
+
         Returns:
             numpy.ndarray: The epsilon mesh.
         """
-        epsilon_r_mesh = numpy.ones(self.grid.shape)
+        start, stop = (0, self.grid.n_x) if rows is None else rows
+
+        epsilon_r_mesh = numpy.ones((stop - start, self.grid.n_y))
         for component in self.components:
-            component.add_to_mesh(epsilon_r_mesh)
+            component.add_to_mesh(epsilon_r_mesh, row_offset=start, subpixel_samples=self.subpixel_samples if self.subpixel_smoothing else None)
 
         return epsilon_r_mesh * Physics.epsilon_0
 
-    def get_field_yee_gradient(self, field: numpy.ndarray) -> Tuple[numpy.ndarray, numpy.ndarray]:
+    def get_field_yee_gradient(self, field: numpy.ndarray, out: Optional[Tuple[numpy.ndarray, numpy.ndarray]] = None) -> Tuple[numpy.ndarray, numpy.ndarray]:
         """
         Calculate the Yee grid gradient of the field.
 
         Args:
             field (numpy.ndarray): The field to calculate the gradient for.
+            out (tuple): Optional preallocated (d_dx, d_dy) arrays of shape (n_x - 1, n_y) and (n_x, n_y - 1) written in place.
 
         Returns:
             tuple: Gradients along x and y directions.
         """
-        d_dx = (field[1:, :] - field[:-1, :]) / self.grid.dx
-        d_dy = (field[:, 1:] - field[:, :-1]) / self.grid.dy
+        if out is None:
+            out = numpy.empty((field.shape[0] - 1, field.shape[1])), numpy.empty((field.shape[0], field.shape[1] - 1))
+
+        d_dx, d_dy = out
+
+        numpy.subtract(field[1:, :], field[:-1, :], out=d_dx)
+        numpy.divide(d_dx, self.grid.dx, out=d_dx)
+
+        numpy.subtract(field[:, 1:], field[:, :-1], out=d_dy)
+        numpy.divide(d_dy, self.grid.dy, out=d_dy)
+
         return d_dx, d_dy
 
-    def run_fdtd(self) -> NoReturn:
-        """Run the FDTD simulation."""
-        Ez = numpy.zeros(self.grid.shape)
-        Hx = numpy.zeros(self.grid.shape)
-        Hy = numpy.zeros(self.grid.shape)
+    def get_update_coefficients(self, rows: Optional[Tuple[int, int]] = None) -> UpdateCoefficients:
+        """
+        Assemble the time-invariant update coefficients from the PML conductivity and the permittivity mesh.
+
+        Args:
+            rows (tuple): Optional (start, stop) band of grid rows to assemble, default is the whole grid.
+
+        Returns:
+            UpdateCoefficients: The per-cell Ca, Cb and Db arrays.
+        """
+        sigma_x, sigma_y = self.get_sigma(rows=rows)
+
+        return UpdateCoefficients(
+            grid=self.grid,
+            sigma_x=sigma_x,
+            sigma_y=sigma_y,
+            epsilon=self.get_epsilon(rows=rows),
+            dtype=self.dtype
+        )
+
+    def get_stepper(
+            self,
+            backend: str = 'numpy',
+            coefficients: Optional[UpdateCoefficients] = None,
+            n_workers: Optional[int] = None) -> NumpyStepper:
+        """
+        Build the leapfrog stepper for the requested backend.
+
+        Args:
+            backend (str): 'numpy' (default), 'native' for the compiled OpenMP kernels or 'threaded' for the slab decomposition over worker threads.
+            coefficients (UpdateCoefficients): Precomputed update coefficients, assembled from the experiment if not given.
+            n_workers (int): Number of worker threads of the 'threaded' backend, default is the number of available cores.
+
+        Returns:
+            NumpyStepper: The stepper advancing the fields in place.
+        """
+        if backend not in steppers:
+            raise ValueError(f"Invalid backend: {backend}. Valid inputs are {list(steppers.keys())}.")
+
+        if coefficients is None:
+            coefficients = self.get_update_coefficients()
+
+        if backend == 'threaded':
+            return steppers[backend](coefficients=coefficients, n_workers=n_workers)
+
+        return steppers[backend](coefficients=coefficients)
+
+    def get_detector_bank(self, **kwargs) -> DetectorBank:
+        """
+        Build the DetectorBank sampling the detectors of the experiment at its precision.
+
+        Args:
+            kwargs: Extra arguments of DetectorBank (e.g. the owned rows of a domain decomposition).
+
+        Returns:
+            DetectorBank: The bank.
+        """
+        return DetectorBank(grid=self.grid, detectors=self.detectors, dtype=self.dtype, monitor_dtype=self.monitor_dtype, **kwargs)
+
+    def get_source_table(self) -> SourceTable:
+        """
+        Precompute the waveforms of all the sources over the time stamps of the grid.
+
+        Returns:
+            SourceTable: The table injecting every source at once.
+        """
+        return SourceTable(sources=self.sources, time=self.grid.time_stamp, dtype=self.dtype)
+
+    def run_fdtd(
+            self,
+            backend: str = 'numpy',
+            recording: Optional[Union[str, Recording]] = None,
+            n_workers: Optional[int] = None,
+            checkpoint: Optional[Checkpoint] = None,
+            stop_criteria: Optional[Union[FieldDecay, MonitorConvergence, list]] = None) -> NoReturn:
+        """
+        Run the FDTD simulation.
+
+        Args:
+            backend (str): Stepping engine, 'numpy' (default), 'native', 'threaded' or 'tiled' (see `run_tiled_fdtd`). All produce the same fields.
+            recording (str | Recording): Which Ez frames are kept in `Ez_t`, 'all', 'none' or a Recording policy.
+                The default is 'all', except for the 'tiled' backend where it is 'none'.
+            n_workers (int): Number of worker threads of the 'threaded' backend, default is the number of available cores.
+            checkpoint (Checkpoint): Optional policy saving the state periodically and resuming from an existing checkpoint file,
+                which is removed once the run completes.
+            stop_criteria (FieldDecay | MonitorConvergence | list): Optional criteria ending the run early as soon as one of them is met.
+                The number of time steps run is stored in `n_steps_run` and the met criterion in `stop_reason`,
+                the detector traces and recorded frames are truncated to the steps run.
+        """
+        if backend == 'tiled':
+            if checkpoint is not None or stop_criteria is not None:
+                raise ValueError("The tiled engine does not support checkpoints nor stop criteria, use another backend.")
+            return self.run_tiled_fdtd(recording='none' if recording is None else recording)
+
+        if recording is None:
+            recording = 'all'
+
+        if stop_criteria is None:
+            stop_criteria = []
+        elif not isinstance(stop_criteria, (list, tuple)):
+            stop_criteria = [stop_criteria]
+
+        coefficients = self.get_update_coefficients()
+
+        self.recording = parse_recording(recording)
+        self.recording.initialize(grid=self.grid, dtype=self.dtype)
+        self.Ez_t = self.recording.data
+
+        detector_bank = self.get_detector_bank()
+
+        Ez = numpy.zeros(self.grid.shape, dtype=self.dtype)
+        Hx = numpy.zeros(self.grid.shape, dtype=self.dtype)
+        Hy = numpy.zeros(self.grid.shape, dtype=self.dtype)
+
+        source_table = self.get_source_table()
 
-        sigma_x, sigma_y = self.get_sigma()
+        non_linear_components = [component for component in self.components if component.is_non_linear]
 
-        epsilon = self.get_epsilon()
-        mu_factor = self.grid.dt / Physics.mu_0
-        eps_factor = self.grid.dt / epsilon
+        cpml = self.pml if isinstance(self.pml, CPML) else None
+        if cpml is not None:
+            cpml.initialize(Ez=Ez, Hx=Hx, Hy=Hy, coefficients=coefficients)
 
-        for iteration, t in enumerate(self.grid.time_stamp):
+        plane_wave = self.plane_wave
+        if plane_wave is not None:
+            self.assert_plane_wave_outside_cpml()
+            plane_wave.initialize(Ez=Ez, Hx=Hx, Hy=Hy, coefficients=coefficients)
 
-            dEz_dx, dEz_dy = self.get_field_yee_gradient(Ez)
+        if stop_criteria:
+            epsilon = self.get_epsilon()
+            for criterion in stop_criteria:
+                criterion.initialize(grid=self.grid, epsilon=epsilon, detector_bank=detector_bank, dtype=self.dtype)
 
-            Hx[:, :-1] -= mu_factor * dEz_dy * (1 - sigma_y[:, :-1] * mu_factor / 2)
-            Hy[:-1, :] += mu_factor * dEz_dx * (1 - sigma_x[:-1, :] * mu_factor / 2)
+        start = 0
+        if checkpoint is not None:
+            state = self.get_loop_state(fields=(Ez, Hx, Hy), cpml=cpml, detector_bank=detector_bank, stop_criteria=stop_criteria)
+            fingerprint = self.get_run_fingerprint(coefficients=coefficients, source_table=source_table, cpml=cpml)
+            start = checkpoint.load(state, fingerprint=fingerprint)
 
-            dHy_dx = (Hy[1:-1, 1:-1] - Hy[:-2, 1:-1]) / self.grid.dx
-            dHx_dy = (Hx[1:-1, 1:-1] - Hx[1:-1, :-2]) / self.grid.dy
+        self.n_steps_run, self.stop_reason = self.grid.n_steps, None
 
-            Ez[1:-1, 1:-1] += eps_factor[1:-1, 1:-1] * (dHy_dx - dHx_dy)
+        with self.get_stepper(backend=backend, coefficients=coefficients, n_workers=n_workers) as stepper:
+            for iteration in range(start, self.grid.n_steps):
 
-            for component in self.components:
-                component.add_non_linear_effect_to_field(Ez)
+                stepper.update_magnetic(Ez, Hx, Hy)
 
-            Ez *= (1 - (sigma_x + sigma_y) * eps_factor / 2)
+                if cpml is not None:
+                    cpml.update_magnetic()
 
-            for source in self.sources:
-                source.add_source_to_field(Ez, time=t)
+                if plane_wave is not None:
+                    plane_wave.update_magnetic()
 
-            self.Ez_t[iteration] = Ez
+                stepper.update_electric(Ez, Hx, Hy)
 
-        for detector in self.detectors:
-            detector.update_data(field=self.Ez_t)
+                if cpml is not None:
+                    cpml.update_electric()
+
+                if plane_wave is not None:
+                    plane_wave.update_electric(iteration)
+
+                for component in non_linear_components:
+                    component.add_non_linear_effect_to_field(Ez)
+
+                stepper.apply_damping(Ez)
+
+                source_table.inject(Ez, iteration)
+
+                self.recording.record(iteration, Ez)
+
+                detector_bank.sample(iteration, Ez)
+
+                met = [criterion for criterion in stop_criteria if criterion.is_met(iteration, Ez, Hx, Hy)]
+                if met:
+                    self.n_steps_run, self.stop_reason = iteration + 1, str(met[0])
+                    break
+
+                # Saved after the criteria, so that their state includes the check of this step.
+                if checkpoint is not None and checkpoint.is_due(iteration):
+                    checkpoint.save(next_iteration=iteration + 1, state=state, fingerprint=fingerprint)
+
+        if checkpoint is not None:
+            checkpoint.discard()
+
+        self.recording.truncate(self.n_steps_run)
+        self.Ez_t = self.recording.data
+
+        detector_bank.finalize(n_steps=self.n_steps_run)
+
+    def get_run_fingerprint(self, coefficients: UpdateCoefficients, source_table: SourceTable, cpml: Optional[CPML]) -> str:
+        """
+        Digest of the arrays defining a run, stored with its checkpoints so that a changed experiment is not resumed.
+
+        Args:
+            coefficients (UpdateCoefficients): The update coefficients, which carry the permittivity and the PML.
+            source_table (SourceTable): The source waveform table and its cells.
+            cpml (CPML): The initialized CPML, if any.
+
+        Returns:
+            str: The digest, see Checkpoint.get_fingerprint.
+        """
+        arrays = [coefficients.Db_x, coefficients.Db_y, coefficients.Cb_x, coefficients.Cb_y, coefficients.Ca]
+        arrays += [source_table.waveforms, source_table.index, source_table.column, source_table.soft_index, source_table.soft_column]
+
+        if cpml is not None:
+            for slab in [*cpml.magnetic_slabs, *cpml.electric_slabs]:
+                arrays += [slab.b, slab.a, slab.kappa_factor, slab.coefficient]
+
+        if self.plane_wave is not None:
+            arrays.append(self.plane_wave.waveform)
+
+        return Checkpoint.get_fingerprint(grid=self.grid, arrays=arrays)
+
+    def get_loop_state(self, fields: Tuple[numpy.ndarray, ...], cpml: Optional[CPML], detector_bank: DetectorBank, stop_criteria: list = ()) -> dict:
+        """
+        Collect the arrays carried from one time step to the next, as saved by a Checkpoint.
+
+        Args:
+            fields (tuple): The Ez, Hx and Hy fields.
+            cpml (CPML): The initialized CPML, if any.
+            detector_bank (DetectorBank): The bank sampling the detectors.
+            stop_criteria (list): The initialized stop criteria, whose state is saved so that a resumed run stops at the same step.
+
+        Returns:
+            dict: The live arrays, by name.
+        """
+        state = dict(zip(['Ez', 'Hx', 'Hy'], fields))
+
+        if cpml is not None:
+            for index, slab in enumerate([*cpml.magnetic_slabs, *cpml.electric_slabs]):
+                state[f'cpml_psi_{index}'] = slab.psi
+
+        for index, array in enumerate(detector_bank.get_accumulators()):
+            state[f'detector_{index}'] = array
+
+        if self.plane_wave is not None:
+            state['plane_wave_Ez'] = self.plane_wave.Ez_incident
+            state['plane_wave_Hy'] = self.plane_wave.Hy_incident
+
+        for index, criterion in enumerate(stop_criteria):
+            for name, array in criterion.get_state().items():
+                state[f'stop_{index}_{name}'] = array
+
+        state['recording'] = self.recording.data
+
+        return state
+
+    def assert_plane_wave_outside_cpml(self) -> NoReturn:
+        """
+        Check that the total-field rectangle of the plane wave does not reach into the CPML slabs.
+        """
+        if not isinstance(self.pml, CPML):
+            return
+
+        wave, width = self.plane_wave, self.pml.width
+        if wave.x_start <= width or wave.y_start <= width or wave.x_stop >= self.grid.n_x - 1 - width or wave.y_stop >= self.grid.n_y - 1 - width:
+            raise ValueError("The total-field rectangle of the plane wave must lie outside of the PML.")
+
+    def run_tiled_fdtd(
+            self,
+            recording: Union[str, Recording] = 'none',
+            tile_shape: Tuple[int, int] = (64, 64),
+            steps_per_block: int = 8) -> NoReturn:
+        """
+        Run the FDTD simulation with the cache-blocked TiledEngine of the compiled extension.
+
+        Several time steps are advanced per pass over the memory, the result
+        is identical to `run_fdtd`. Blocks are cut at every recorded frame,
+        so recording many frames removes the benefit. The CPML and the
+        non-linear components are not supported.
+
+        Args:
+            recording (str | Recording): Which Ez frames are kept in `Ez_t`, 'none' (default), 'all' or a Recording policy.
+            tile_shape (tuple): Number of cells (along x, along y) owned by a tile, a tile with its halo should fit in the L2 cache.
+            steps_per_block (int): Maximum number of time steps advanced per pass.
+        """
+        if isinstance(self.pml, CPML):
+            raise ValueError("The tiled engine does not support the CPML, use add_pml or another backend.")
+
+        if any(component.is_non_linear for component in self.components):
+            raise ValueError("The tiled engine does not support non-linear components, use another backend.")
+
+        if self.plane_wave is not None or any(source.mode == 'soft' for source in self.sources):
+            raise ValueError("The tiled engine only supports hard sources, use another backend.")
+
+        engine = TiledEngine(coefficients=self.get_update_coefficients(), tile_shape=tile_shape, steps_per_block=steps_per_block)
+
+        self.recording = parse_recording(recording)
+        self.recording.initialize(grid=self.grid, dtype=self.dtype)
+        self.Ez_t = self.recording.data
+
+        if self.recording.frame_indices.size >= self.grid.n_steps:
+            warnings.warn("Every time step is recorded, the tiled engine advances one step per pass and runs slower than the other backends.")
+
+        detector_bank = self.get_detector_bank()
+        source_table = self.get_source_table()
+        source_index, source_values = source_table.index, source_table.get_cell_values()
+
+        for start, stop in engine.get_blocks(n_steps=self.grid.n_steps, stops=self.recording.frame_indices):
+            probes = engine.advance(
+                n_steps=stop - start,
+                source_index=source_index,
+                source_values=source_values[start:stop],
+                probe_index=detector_bank.index
+            )
+
+            if detector_bank.index.size:
+                for offset, values in enumerate(probes):
+                    detector_bank.store(start + offset, values)
+
+            self.recording.record(stop - 1, engine.Ez)
+
+        self.n_steps_run, self.stop_reason = self.grid.n_steps, None
+
+        detector_bank.finalize()
 
     def plot_frame(
             self,
@@ -283,7 +629,7 @@ class Experiment:
         relevant simulation components, sources, and detectors for a given frame.
 
         Args:
-            frame_number (int): The index of the frame to be visualized.
+            frame_number (int): The index of the frame to be visualized among the recorded frames.
             colormap (Optional[Union[str, object]]): The colormap used for the visualization.
                 Defaults to a blue-black-red colormap from Polytechnique collection.
 
@@ -292,9 +638,11 @@ class Experiment:
         """
         figure, ax = self.get_figure_ax(unit_size=unit_size)
 
+        self.assert_frames_recorded()
+
         image = ax.pcolormesh(
-            self.grid.x_stamp,
-            self.grid.y_stamp,
+            self.recording.x_stamp,
+            self.recording.y_stamp,
             self.Ez_t[frame_number].T,
             cmap=colormap
         )
@@ -325,7 +673,7 @@ class Experiment:
         of a specific frame and then saves it as an image file using the given colormap.
 
         Args:
-            frame_number (int): The index of the frame to be saved.
+            frame_number (int): The index of the frame to be saved among the recorded frames.
             filename (str): The file path where the image will be saved.
             dpi (int): The resolution of the saved image in dots per inch.
             colormap (Optional[Union[str, object]]): The colormap used for visualizing the data.
@@ -336,9 +684,11 @@ class Experiment:
         """
         figure, ax = self.get_figure_ax(unit_size=unit_size)
 
+        self.assert_frames_recorded()
+
         image = ax.pcolormesh(
-            self.grid.x_stamp,
-            self.grid.y_stamp,
+            self.recording.x_stamp,
+            self.recording.y_stamp,
             self.Ez_t[frame_number].T,
             cmap=colormap
         )
@@ -354,6 +704,12 @@ class Experiment:
 
         plt.savefig(filename, dpi=dpi)
 
+    def assert_frames_recorded(self) -> NoReturn:
+        """
+        Ensure the last run kept at least one Ez frame to display.
+        """
+        assert self.Ez_t is not None and len(self.Ez_t) > 0, "No field frame recorded, run the simulation with a recording policy that keeps frames."
+
     def get_figure_ax(self, unit_size: int = 6) -> Tuple:
         figsize = int(unit_size), int(unit_size * self.grid.size_y / self.grid.size_x)
         figure, ax = plt.subplots(1, 1, figsize=figsize)
@@ -384,20 +740,22 @@ class Experiment:
         and creates an animation showing the evolution of the field over time.
 
         Args:
-            skip_frame (int): The number of time steps to skip between frames in the animation.
+            skip_frame (int): The number of recorded frames to skip between frames in the animation.
             colormap (Optional[Union[str, object]]): The colormap used for visualizing the data. Defaults to a predefined blue-black-red colormap.
             unit_size (float): The base unit size for scaling the plot elements.
 
         Returns:
             animation.FuncAnimation: The animation object that can be displayed or saved.
         """
+        self.assert_frames_recorded()
+
         figure, ax = self.get_figure_ax(unit_size=unit_size)
 
         # Initialize the field display
         initial_field = numpy.zeros(self.Ez_t[0].shape).T
         field_artist = ax.pcolormesh(
-            self.grid.x_stamp,
-            self.grid.y_stamp,
+            self.recording.x_stamp,
+            self.recording.y_stamp,
             initial_field,
             cmap=colormap
         )
@@ -433,7 +791,7 @@ class Experiment:
         render = animation.FuncAnimation(
             fig=figure,
             func=update,
-            frames=numpy.arange(0, self.grid.n_steps, skip_frame),
+            frames=numpy.arange(0, len(self.Ez_t), skip_frame),
             interval=0.2,
             blit=True,
             init_func=init_func
@@ -0,0 +1,296 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+from typing import NoReturn, Optional, List, Tuple, Union
+import numpy
+import scipy.sparse
+import scipy.sparse.linalg
+from LightWave2D.physics import Physics
+from LightWave2D.grid import Grid
+from LightWave2D.pml import PML, CPML
+from LightWave2D.source import Impulsion
+from LightWave2D.experiment import Experiment
+import matplotlib.pyplot as plt
+
+
+class StretchedLaplacian:
+    """
+    Laplacian of the Ez nodes of a grid in stretched coordinates (SC-PML), shared by the frequency domain solvers.
+
+    The derivatives are the Yee differences of the time domain engine, with
+    Ez = 0 right outside of the grid, divided by the complex stretch
+    s = kappa + sigma / (alpha + i omega epsilon_0) of the PML. A CPML gives
+    its grading; a PML contributes its width and order to a CPML with the
+    default optimal grading. The stretch depends on the angular frequency,
+    which is passed to every call.
+
+    Args:
+        grid (Grid): The grid of the simulation mesh.
+        pml (PML | CPML): The PML of the experiment, None for a closed box.
+    """
+
+    def __init__(self, grid: Grid, pml: Optional[Union[PML, CPML]]):
+        self.grid = grid
+        self.cpml = self.get_cpml(pml)
+
+    def get_cpml(self, pml: Optional[Union[PML, CPML]]) -> Optional[CPML]:
+        """
+        CPML whose grading defines the stretched coordinates, None without PML.
+        """
+        if isinstance(pml, CPML):
+            return pml
+
+        if isinstance(pml, PML):
+            return CPML(grid=self.grid, width=pml.width, order=pml.order)
+
+        return None
+
+    def get_stretch(self, n: int, offset: float, omega: float) -> numpy.ndarray:
+        """
+        Complex coordinate stretching s along an axis.
+
+        Args:
+            n (int): Number of cells along the axis.
+            offset (float): 0 for Ez nodes, 0.5 for the staggered H nodes.
+            omega (float): The angular frequency [rad/s].
+
+        Returns:
+            numpy.ndarray: s, one where there is no PML.
+        """
+        if self.cpml is None:
+            return numpy.ones(n, dtype=complex)
+
+        sigma, kappa, alpha = self.cpml.get_profile(n=n, offset=offset)
+
+        return kappa + sigma / (alpha + 1j * omega * Physics.epsilon_0)
+
+    def get_derivative(self, n: int, step: float, omega: float) -> Tuple[scipy.sparse.csr_matrix, scipy.sparse.csr_matrix]:
+        """
+        Stretched forward (Ez nodes to H nodes) and backward (H nodes to Ez nodes) differences along one axis.
+
+        Args:
+            n (int): Number of cells along the axis.
+            step (float): Cell size along the axis.
+            omega (float): The angular frequency [rad/s].
+
+        Returns:
+            tuple: The forward and backward difference matrices of shape (n, n).
+        """
+        forward = scipy.sparse.diags([-numpy.ones(n), numpy.ones(n - 1)], [0, 1], shape=(n, n)) / step
+        backward = -forward.T
+
+        forward = scipy.sparse.diags(1 / self.get_stretch(n=n, offset=0.5, omega=omega)) @ forward
+        backward = scipy.sparse.diags(1 / self.get_stretch(n=n, offset=0, omega=omega)) @ backward
+
+        return forward.tocsr(), backward.tocsr()
+
+    def get_matrix(self, omega: float) -> scipy.sparse.csr_matrix:
+        """
+        Stretched Laplacian of the Ez nodes, flattened in the C order of the grid.
+
+        Args:
+            omega (float): The angular frequency [rad/s].
+
+        Returns:
+            scipy.sparse.csr_matrix: Matrix of shape (n_x n_y, n_x n_y).
+        """
+        n_x, n_y = self.grid.shape
+
+        forward_x, backward_x = self.get_derivative(n=n_x, step=self.grid.dx, omega=omega)
+        forward_y, backward_y = self.get_derivative(n=n_y, step=self.grid.dy, omega=omega)
+
+        laplacian_x = scipy.sparse.kron(backward_x @ forward_x, scipy.sparse.identity(n_y))
+        laplacian_y = scipy.sparse.kron(scipy.sparse.identity(n_x), backward_y @ forward_y)
+
+        return (laplacian_x + laplacian_y).tocsr()
+
+
+class FrequencyDomainExperiment:
+    """
+    Finite-difference frequency-domain (FDFD) solver of the TMz Helmholtz equation at a single wavelength.
+
+    The geometry is the one of an Experiment: its Grid, its permittivity
+    (`get_epsilon`, subpixel smoothing included) and its PML, which is
+    turned into a stretched-coordinate PML (SC-PML). The fields are phasors
+    with the exp(i omega t) convention, i.e. Ez(t) = Re(Ez exp(i omega t)),
+    and solve
+
+        1/s_x d/dx (1/s_x dEz/dx) + 1/s_y d/dy (1/s_y dEz/dy) + omega**2 mu_0 epsilon Ez = i omega mu_0 Jz
+
+    on the same Yee grid as the time domain engine, with Ez = 0 right
+    outside of the grid and the stretch s of StretchedLaplacian.
+
+    The sparse operator is factorized once (LU with scipy's SuperLU, or an
+    incomplete LU preconditioner for GMRES with solver='iterative') and the
+    factorization is reused by every `solve`, so sweeping sources costs one
+    triangular solve each. Several right-hand sides can be solved at once.
+
+    Sources are soft current sources: a time domain source adding
+    ``A sin(omega t)`` to Ez at every step injects Jz = -epsilon A sin(omega t) / dt,
+    whose phasor i epsilon A / dt is used here. The solution is then the
+    steady state of the matching time domain run with mode='soft' sources,
+    up to the time discretization. A hard source overwrites Ez instead of
+    driving it and has no current equivalent, it is refused.
+
+    Args:
+        experiment (Experiment): The experiment giving the geometry and the sources.
+        wavelength (float): The vacuum wavelength.
+        solver (str): 'direct' (default) for a sparse LU factorization, 'iterative' for ILU-preconditioned GMRES.
+        tolerance (float): Relative residual of the iterative solver (default is 1e-8).
+    """
+
+    def __init__(self, experiment: Experiment, wavelength: float, solver: str = 'direct', tolerance: float = 1e-8):
+        if solver not in ['direct', 'iterative']:
+            raise ValueError(f"Invalid solver: {solver}. Valid inputs are ['direct', 'iterative'].")
+
+        if any(component.is_non_linear for component in experiment.components):
+            raise ValueError("The frequency domain solver is linear, remove the non-linear components.")
+
+        if experiment.plane_wave is not None:
+            raise ValueError("The frequency domain solver does not support plane waves, use a LineSource.")
+
+        self.experiment = experiment
+        self.grid = experiment.grid
+        self.wavelength = wavelength
+        self.omega = 2 * numpy.pi * Physics.c / wavelength
+        self.solver = solver
+        self.tolerance = tolerance
+
+        self.epsilon = experiment.get_epsilon()
+        self.laplacian = StretchedLaplacian(grid=self.grid, pml=experiment.pml)
+
+        self.operator = self.get_operator()
+        self.factorization = None
+        self.Ez = None
+
+    def get_laplacian(self) -> scipy.sparse.csr_matrix:
+        """
+        Stretched Laplacian of the Ez nodes at the angular frequency of the solver.
+
+        Returns:
+            scipy.sparse.csr_matrix: Matrix of shape (n_x n_y, n_x n_y).
+        """
+        return self.laplacian.get_matrix(omega=self.omega)
+
+    def get_operator(self) -> scipy.sparse.csc_matrix:
+        """
+        Helmholtz operator A such that A Ez = i omega mu_0 Jz.
+
+        Returns:
+            scipy.sparse.csc_matrix: Matrix of shape (n_x n_y, n_x n_y).
+        """
+        mass = scipy.sparse.diags(self.omega**2 * Physics.mu_0 * self.epsilon.ravel())
+
+        return (self.get_laplacian() + mass).tocsc()
+
+    def factorize(self) -> NoReturn:
+        """
+        Factorize the operator, or build the preconditioner of the iterative solver, if not done yet.
+        """
+        if self.factorization is not None:
+            return
+
+        if self.solver == 'direct':
+            self.factorization = scipy.sparse.linalg.splu(self.operator)
+        else:
+            self.factorization = scipy.sparse.linalg.spilu(self.operator, drop_tol=1e-5, fill_factor=20)
+
+    def get_current(self, sources: Optional[List] = None) -> numpy.ndarray:
+        """
+        Current density phasor of the time domain sources oscillating at the wavelength of the solver.
+
+        PointSource and LineSource contribute when one of their wavelengths
+        matches, with the amplitude weight of the time domain source. The
+        matching sources must be soft (mode='soft').
+
+        Args:
+            sources (list): The sources, default is the sources of the experiment.
+
+        Returns:
+            numpy.ndarray: Complex Jz of the grid shape [A/m^2].
+        """
+        sources = self.experiment.sources if sources is None else sources
+        current = numpy.zeros(self.grid.n_x * self.grid.n_y, dtype=complex)
+
+        for source in sources:
+            # The carrier of a pulse is not a steady state oscillation.
+            if isinstance(source, Impulsion):
+                continue
+
+            wavelengths = numpy.atleast_1d(source.wavelength)
+            matching = numpy.isclose(wavelengths, self.wavelength, rtol=1e-9).sum()
+            if not matching:
+                continue
+
+            if source.mode != 'soft':
+                raise ValueError("The frequency domain solver only supports soft sources, a hard source has no current equivalent: use mode='soft'.")
+
+            amplitude = source.amplitude * matching / wavelengths.size
+            numpy.add.at(current, source.flat_index, 1j * self.epsilon.ravel()[source.flat_index] * amplitude / self.grid.dt)
+
+        if not current.any():
+            raise ValueError(f"No source of the experiment oscillates at the wavelength {self.wavelength}.")
+
+        return current.reshape(self.grid.shape)
+
+    def solve(self, current: Optional[numpy.ndarray] = None) -> numpy.ndarray:
+        """
+        Solve for the Ez phasor.
+
+        Args:
+            current (numpy.ndarray): Complex Jz of the grid shape, or a stack of them of shape (n_rhs, n_x, n_y).
+                Default is the current of the experiment's sources.
+
+        Returns:
+            numpy.ndarray: Complex Ez of the same shape as `current`, also stored in `Ez` for a single right-hand side.
+        """
+        if current is None:
+            current = self.get_current()
+
+        current = numpy.asarray(current)
+        shape = current.shape
+        right_hand_side = 1j * self.omega * Physics.mu_0 * current.reshape(-1, self.grid.n_x * self.grid.n_y).T
+
+        self.factorize()
+
+        if self.solver == 'direct':
+            solution = self.factorization.solve(numpy.ascontiguousarray(right_hand_side))
+        else:
+            preconditioner = scipy.sparse.linalg.LinearOperator(self.operator.shape, self.factorization.solve, dtype=complex)
+            solution = numpy.empty_like(right_hand_side)
+            for index in range(right_hand_side.shape[1]):
+                solution[:, index], info = scipy.sparse.linalg.gmres(
+                    self.operator, right_hand_side[:, index], M=preconditioner, rtol=self.tolerance, restart=200, maxiter=1000
+                )
+                if info != 0:
+                    raise RuntimeError(f"GMRES did not converge (info={info}), use solver='direct'.")
+
+        Ez = solution.T.reshape(shape)
+
+        if Ez.ndim == 2:
+            self.Ez = Ez
+
+        return Ez
+
+    def plot_field(self, scale: str = 'abs') -> NoReturn:
+        """
+        Plot the solved field.
+
+        Args:
+            scale (str): 'abs' for the magnitude (default) or 'real' for the field at t = 0.
+        """
+        assert self.Ez is not None, "No field solved, call solve first."
+
+        field = abs(self.Ez) if scale == 'abs' else self.Ez.real
+
+        figure, ax = self.experiment.get_figure_ax()
+        image = ax.pcolormesh(self.grid.x_stamp, self.grid.y_stamp, field.T, cmap='viridis' if scale == 'abs' else 'RdBu_r')
+        plt.colorbar(image, ax=ax, label='|Ez|' if scale == 'abs' else 'Re(Ez)')
+
+        for component in self.experiment.components:
+            component.add_to_ax(ax)
+
+        ax.set_title(f'FDFD, wavelength: {self.wavelength:.3e} m')
+        plt.show()
+
+# -
@@ -0,0 +1,214 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+from typing import NoReturn, Optional, Tuple
+import numpy
+from LightWave2D.physics import Physics
+import matplotlib.pyplot as plt
+
+
+class HarmonicInversion:
+    """
+    Resonances of a time trace by harmonic inversion with the matrix pencil method.
+
+    The trace is modelled as a sum of damped oscillations
+    ``sum_k a_k exp(i phi_k) exp((i omega_k - gamma_k) t)``. The poles
+    ``z_k = exp((i omega_k - gamma_k) dt)`` are the eigenvalues of the
+    pencil built from the dominant right singular vectors of the Hankel
+    matrix of the samples, and the complex amplitudes follow from a linear
+    least-squares fit. Unlike an FFT, whose resolution is 1 / (n dt), the
+    frequencies and decay rates are resolved by the model as soon as the
+    trace holds a few periods of each resonance above the noise, so
+    resonator runs only need to last a fraction of the ring-down time.
+
+    The trace should start after the excitation has ended (`start_time`),
+    when only the free decay of the modes remains. A real trace gives pairs
+    of conjugate poles, only the positive frequencies are kept.
+
+    The SVD of the Hankel matrix costs O(n L**2) for n samples and a pencil
+    of L columns. The pencil is n / 3, capped at `max_pencil`, which is
+    plenty as long as the model order stays well below it. FDTD traces are
+    sampled far above the frequencies of interest, so when a band is given
+    and no stride, the stride keeps four samples per period of its shortest
+    wavelength (twice the Nyquist rate): a 20 cells per wavelength run is
+    decimated seven times. Content above the new Nyquist frequency,
+    if any, aliases into the band.
+
+    Args:
+        trace (numpy.ndarray): Uniformly sampled signal, e.g. PointDetector.data.
+        dt (float): Sampling interval [s].
+        start_index (int): Index of the first sample used (default is 0).
+        stride (int): Take one sample every `stride`, which shrinks the problem for traces sampled far above the
+            highest frequency of interest. Frequencies above 1 / (2 stride dt) alias. Default is 1, or four
+            samples per period of the shortest wavelength of `wavelength_range` when it is given.
+        n_modes (int): Model order, default is the number of singular values above `tolerance` times the largest one.
+        tolerance (float): Relative singular value threshold selecting the model order (default is 1e-6).
+        wavelength_range (Tuple[float, float]): Optional band of vacuum wavelengths of the reported resonances.
+        max_pencil (int): Largest number of columns of the Hankel matrix (default is 1000).
+
+    Attributes:
+        frequency (numpy.ndarray): Resonance frequencies [Hz], sorted by decreasing amplitude.
+        wavelength (numpy.ndarray): Vacuum wavelengths [m].
+        decay_rate (numpy.ndarray): Amplitude decay rates gamma [1/s].
+        quality_factor (numpy.ndarray): Q = omega / (2 gamma).
+        amplitude (numpy.ndarray): Amplitudes at the first sample used.
+        phase (numpy.ndarray): Phases at the first sample used [rad].
+    """
+
+    def __init__(
+            self,
+            trace: numpy.ndarray,
+            dt: float,
+            start_index: int = 0,
+            stride: Optional[int] = None,
+            n_modes: Optional[int] = None,
+            tolerance: float = 1e-6,
+            wavelength_range: Optional[Tuple[float, float]] = None,
+            max_pencil: int = 1000):
+
+        if stride is None:
+            stride = self.get_stride(dt=dt, wavelength_range=wavelength_range)
+
+        self.stride = stride
+        self.max_pencil = max_pencil
+        self.samples = numpy.asarray(trace)[start_index::stride]
+        self.dt = dt * stride
+        self.start_time = start_index * dt
+
+        if self.samples.size < 4:
+            raise ValueError("The harmonic inversion needs at least 4 samples.")
+
+        poles = self.get_poles(n_modes=n_modes, tolerance=tolerance)
+        residues = self.get_residues(poles)
+
+        complex_frequency = numpy.log(poles) / self.dt
+        omega, decay_rate = complex_frequency.imag, -complex_frequency.real
+
+        # Conjugate poles of a real trace are folded on the positive frequencies with twice the amplitude.
+        keep = omega > 0
+        if wavelength_range is not None:
+            low, high = 2 * numpy.pi * Physics.c / max(wavelength_range), 2 * numpy.pi * Physics.c / min(wavelength_range)
+            keep &= (omega >= low) & (omega <= high)
+
+        scale = 1 if numpy.iscomplexobj(self.samples) else 2
+        order = numpy.argsort(-abs(residues[keep]))
+
+        self.poles = poles[keep][order]
+        self.residues = scale * residues[keep][order]
+        self.frequency = omega[keep][order] / (2 * numpy.pi)
+        self.wavelength = Physics.c / self.frequency
+        self.decay_rate = decay_rate[keep][order]
+        self.quality_factor = omega[keep][order] / (2 * self.decay_rate)
+        self.amplitude = abs(self.residues)
+        self.phase = numpy.angle(self.residues)
+
+    @classmethod
+    def from_detector(cls, detector: 'PointDetector', start_time: float = 0, **kwargs) -> 'HarmonicInversion':
+        """
+        Harmonic inversion of the trace of a PointDetector after a simulation.
+
+        Args:
+            detector (PointDetector): A coherent detector.
+            start_time (float): Time from which the trace is used, after the excitation [s].
+            kwargs: Other arguments of HarmonicInversion.
+        """
+        if not detector.coherent:
+            raise ValueError("The harmonic inversion requires a coherent detector.")
+
+        start_index = int(numpy.ceil(start_time / detector.grid.dt))
+
+        return cls(trace=detector.data, dt=detector.grid.dt, start_index=start_index, **kwargs)
+
+    @staticmethod
+    def get_stride(dt: float, wavelength_range: Optional[Tuple[float, float]]) -> int:
+        """
+        Decimation keeping four samples per period of the shortest wavelength of the band, 1 without band.
+
+        Args:
+            dt (float): Sampling interval of the trace [s].
+            wavelength_range (Tuple[float, float]): The band of vacuum wavelengths, if any.
+
+        Returns:
+            int: The stride.
+        """
+        if wavelength_range is None:
+            return 1
+
+        omega_max = 2 * numpy.pi * Physics.c / min(wavelength_range)
+
+        return max(1, int(numpy.pi / (2 * omega_max * dt)))
+
+    def get_poles(self, n_modes: Optional[int], tolerance: float) -> numpy.ndarray:
+        """
+        Poles of the signal from the matrix pencil of its Hankel matrix.
+
+        Args:
+            n_modes (int): The model order, None to select it from the singular values.
+            tolerance (float): Relative singular value threshold.
+
+        Returns:
+            numpy.ndarray: The complex poles z_k.
+        """
+        n = self.samples.size
+        pencil = self.pencil = min(n // 3, self.max_pencil)
+
+        index = numpy.arange(n - pencil)[:, None] + numpy.arange(pencil + 1)
+        # The rows of the Hankel matrix, hence the dominant rows of Vh, span the vectors (z_k**j).
+        _, singular_values, right = numpy.linalg.svd(self.samples[index], full_matrices=False)
+
+        if n_modes is None:
+            n_modes = int(numpy.sum(singular_values > tolerance * singular_values[0]))
+
+        n_modes = max(1, min(n_modes, pencil))
+        basis = right[:n_modes].T
+
+        return numpy.linalg.eigvals(numpy.linalg.pinv(basis[:-1]) @ basis[1:])
+
+    def get_residues(self, poles: numpy.ndarray) -> numpy.ndarray:
+        """
+        Complex amplitudes of the poles fitting the samples in the least-squares sense.
+
+        Args:
+            poles (numpy.ndarray): The complex poles z_k.
+
+        Returns:
+            numpy.ndarray: The complex amplitude of every pole at the first sample.
+        """
+        vandermonde = poles[None, :] ** numpy.arange(self.samples.size)[:, None]
+
+        return numpy.linalg.lstsq(vandermonde, self.samples.astype(complex), rcond=None)[0]
+
+    def reconstruct(self, time: numpy.ndarray) -> numpy.ndarray:
+        """
+        Real signal of the reported resonances at given times.
+
+        Args:
+            time (numpy.ndarray): The times [s], on the clock of the original trace.
+
+        Returns:
+            numpy.ndarray: The sum of the damped oscillations.
+        """
+        exponent = (2j * numpy.pi * self.frequency - self.decay_rate) * (numpy.asarray(time)[..., None] - self.start_time)
+
+        return (self.residues * numpy.exp(exponent)).sum(axis=-1).real
+
+    def __str__(self) -> str:
+        lines = [f"{'wavelength [m]':>16}{'Q':>14}{'decay rate [1/s]':>20}{'amplitude':>14}"]
+        for wavelength, quality_factor, decay_rate, amplitude in zip(self.wavelength, self.quality_factor, self.decay_rate, self.amplitude):
+            lines.append(f"{wavelength:>16.6e}{quality_factor:>14.4e}{decay_rate:>20.4e}{amplitude:>14.4e}")
+
+        return "\n".join(lines)
+
+    def plot(self) -> NoReturn:
+        """
+        Plot the resonances, Q against wavelength with the marker size following the amplitude.
+        """
+        figure, ax = plt.subplots(1, 1)
+        sizes = 100 * self.amplitude / self.amplitude.max() if self.amplitude.size else 1
+        ax.scatter(self.wavelength, self.quality_factor, s=sizes)
+        ax.set_yscale('log')
+        ax.set_xlabel('Wavelength [m]')
+        ax.set_ylabel('Quality factor')
+        plt.show()
+
+# -
@@ -0,0 +1,120 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+import copy
+from typing import NoReturn, Union
+import numpy
+from LightWave2D.experiment import Experiment
+from LightWave2D.detector import PointDetector
+
+
+class UnitSample:
+    """
+    Source writing 1 at the first time step and 0 afterwards, on the cells of another source.
+
+    Args:
+        source: The source whose cells and mode are used.
+    """
+
+    def __init__(self, source):
+        self.flat_index = source.flat_index
+        self.mode = source.mode
+
+    def get_waveform(self, time: numpy.ndarray) -> numpy.ndarray:
+        waveform = numpy.zeros((numpy.size(time), 1))
+        waveform[0] = 1
+        return waveform
+
+
+class ImpulseResponse:
+    """
+    Responses of the point detectors of an experiment to a unit sample written at the cells of one of its sources.
+
+    Without non-linear components the leapfrog is linear and time
+    invariant, and a source writes (hard) or adds (soft) a sequence of
+    values at fixed cells. The trace of every detector is therefore the
+    discrete convolution of the waveform with the trace obtained for a unit
+    sample at the first step. One run of that unit sample, the other sources
+    removed, answers any waveform from the same cells (any wavelength list,
+    pulse shape, amplitude) with an FFT convolution and no time stepping.
+    The result equals the one of `run_fdtd` up to round-off.
+
+    The run is made on a copy of the experiment, which is left untouched.
+
+    Args:
+        experiment (Experiment): The experiment, its sources are ignored except for `source`.
+        source: The source giving the cells and the mode (hard or soft) of the injection, one of `experiment.sources` or any source at the same cells.
+        kwargs: Extra arguments of `run_fdtd` for the unit sample run (e.g. backend).
+    """
+
+    def __init__(self, experiment: Experiment, source, **kwargs):
+        if any(component.is_non_linear for component in experiment.components):
+            raise ValueError("The impulse response requires a linear experiment, remove the non-linear components.")
+
+        point_detectors = [detector for detector in experiment.detectors if isinstance(detector, PointDetector)]
+        if not point_detectors:
+            raise ValueError("The impulse response requires at least one PointDetector in the experiment.")
+
+        if not all(detector.coherent for detector in point_detectors):
+            raise ValueError("The impulse response requires coherent detectors, the magnitude of a trace is not linear in the source.")
+
+        self.grid = experiment.grid
+        self.source = source
+
+        unit_run = copy.deepcopy(experiment)
+        unit_run.sources = [UnitSample(source)]
+        unit_run.plane_wave = None
+        unit_run.run_fdtd(recording='none', **kwargs)
+
+        self.detectors = [detector for detector in unit_run.detectors if isinstance(detector, PointDetector)]
+        self.responses = numpy.stack([numpy.asarray(detector.data, dtype=float) for detector in self.detectors])
+
+        n_steps = self.grid.n_steps
+        self.n_fft = 1 << int(numpy.ceil(numpy.log2(2 * n_steps)))
+        self.transfer = numpy.fft.rfft(self.responses, n=self.n_fft, axis=-1)
+
+    def check_source(self, source) -> NoReturn:
+        """
+        Raise a ValueError if the source does not write the cells of the impulse response with its mode.
+        """
+        if not numpy.array_equal(numpy.sort(source.flat_index), numpy.sort(self.source.flat_index)) or source.mode != self.source.mode:
+            raise ValueError("The source must write the same cells with the same mode as the source of the impulse response.")
+
+    def get_traces(self, waveform: Union[numpy.ndarray, object]) -> numpy.ndarray:
+        """
+        Traces of the detectors for a given source waveform.
+
+        Args:
+            waveform (numpy.ndarray | source): The values written by the source at every time step, shape (n_steps,),
+                or a source at the same cells whose `get_waveform` gives them.
+
+        Returns:
+            numpy.ndarray: Traces of shape (n_detector, n_steps), in the order of the point detectors of the experiment.
+        """
+        if not isinstance(waveform, numpy.ndarray):
+            self.check_source(waveform)
+            waveform = waveform.get_waveform(self.grid.time_stamp)[:, 0]
+
+        if waveform.shape != (self.grid.n_steps,):
+            raise ValueError(f"The waveform must hold one value per time step, shape ({self.grid.n_steps},).")
+
+        spectrum = numpy.fft.rfft(waveform, n=self.n_fft)
+
+        return numpy.fft.irfft(self.transfer * spectrum, n=self.n_fft, axis=-1)[:, :self.grid.n_steps]
+
+    def apply(self, source) -> list:
+        """
+        Fill the data of the point detectors of the copied experiment with their traces for a source.
+
+        Args:
+            source: A source at the same cells as the source of the impulse response.
+
+        Returns:
+            list: The point detectors, with their data set.
+        """
+        for detector, trace in zip(self.detectors, self.get_traces(source)):
+            detector.set_data(trace[:, None])
+
+        return self.detectors
+
+# -
@@ -1,9 +1,10 @@
 #!/usr/bin/env python
 # -*- coding: utf-8 -*-
 
-from typing import NoReturn
+from typing import NoReturn, Optional, Tuple
 import numpy
 from LightWave2D.grid import Grid
+from LightWave2D.physics import Physics
 from pydantic.dataclasses import dataclass
 from matplotlib.colors import ListedColormap
 import matplotlib.pyplot as plt
@@ -16,6 +17,43 @@ config_dict = dict(
 )
 
 
+def get_graded_depth(n: int, width: int, offset: float = 0) -> numpy.ndarray:
+    """
+    Normalized depth into a boundary layer of the nodes i + offset along an axis of n cells.
+
+    Args:
+        n (int): Number of cells along the axis.
+        width (int): Width of the layer in cells, on both ends of the axis.
+        offset (float): 0 for Ez nodes, 0.5 for the staggered H nodes.
+
+    Returns:
+        numpy.ndarray: Depth in [0, 1], zero outside of the layer.
+    """
+    position = numpy.arange(n) + offset
+    left = (width - position) / width
+    right = (position - (n - width - 1)) / width
+    return numpy.clip(numpy.maximum(left, right), 0, 1)
+
+
+def get_grading(n: int, width: int, order: int, offset: float = 0) -> numpy.ndarray:
+    """
+    Polynomial grading depth**order of a boundary layer, zero outside of the layer for any order.
+
+    Args:
+        n (int): Number of cells along the axis.
+        width (int): Width of the layer in cells, on both ends of the axis.
+        order (int): Polynomial order, 0 for a constant profile inside the layer.
+        offset (float): 0 for Ez nodes, 0.5 for the staggered H nodes.
+
+    Returns:
+        numpy.ndarray: Grading in [0, 1].
+    """
+    depth = get_graded_depth(n=n, width=width, offset=offset)
+
+    # numpy gives 0.0 ** 0 == 1, the cells outside of the layer are masked explicitly.
+    return numpy.where(depth > 0, depth ** order, 0)
+
+
 @dataclass(config=config_dict)
 class PML():
     grid: Grid
@@ -28,22 +66,13 @@ class PML():
     """ Polynomial order of sigma profile """
 
     def __post_init__(self):
-        self.sigma_x = numpy.zeros((self.grid.n_x, self.grid.n_y))
-        self.sigma_y = numpy.zeros((self.grid.n_x, self.grid.n_y))
-
-        for i in range(self.grid.n_x):
-            for j in range(self.grid.n_y):
-                # Left and right PML regions
-                if i < self.width:
-                    self.sigma_x[i, j] = self.sigma_max * ((self.width - i) / self.width) ** self.order
-                elif i >= self.grid.n_x - self.width:
-                    self.sigma_x[i, j] = self.sigma_max * ((i - (self.grid.n_x - self.width - 1)) / self.width) ** self.order
-
-                # Top and bottom PML regions
-                if j < self.width:
-                    self.sigma_y[i, j] = self.sigma_max * ((self.width - j) / self.width) ** self.order
-                elif j >= self.grid.n_y - self.width:
-                    self.sigma_y[i, j] = self.sigma_max * ((j - (self.grid.n_y - self.width - 1)) / self.width) ** self.order
+        # The profiles are separable: sigma_x only depends on i and sigma_y on j,
+        # the full-grid arrays are read-only broadcast views of the 1D ramps.
+        self.sigma_x_profile = self.sigma_max * get_grading(n=self.grid.n_x, width=self.width, order=self.order)
+        self.sigma_y_profile = self.sigma_max * get_grading(n=self.grid.n_y, width=self.width, order=self.order)
+
+        self.sigma_x = numpy.broadcast_to(self.sigma_x_profile[:, None], self.grid.shape)
+        self.sigma_y = numpy.broadcast_to(self.sigma_y_profile[None, :], self.grid.shape)
 
     def add_to_ax(self, ax: plt.axis) -> NoReturn:
         cmap = numpy.zeros([256, 4])
@@ -70,4 +99,251 @@ class PML():
 
         plt.show()
 
+
+class CPMLSlab:
+    """
+    Convolutional PML correction on one boundary slab for one field component.
+
+    The slab applies, on top of the bulk leapfrog update,
+
+        psi = b * psi + a * (plus - minus)
+        target += sign * coefficient * ((1 / kappa - 1) * (plus - minus) + psi)
+
+    where `plus - minus` is the Yee difference of the driving field and
+    `coefficient` the matching bulk coefficient (Db or Cb), so the auxiliary
+    array `psi` only covers the slab.
+
+    Args:
+        target (numpy.ndarray): View of the updated field over the slab.
+        plus (numpy.ndarray): View of the leading operand of the Yee difference.
+        minus (numpy.ndarray): View of the trailing operand of the Yee difference.
+        coefficient (numpy.ndarray): View of the bulk update coefficient over the slab.
+        b (numpy.ndarray): Recursive convolution decay, broadcastable to the slab.
+        a (numpy.ndarray): Recursive convolution weight, broadcastable to the slab.
+        kappa_factor (numpy.ndarray): 1 / kappa - 1, broadcastable to the slab.
+        sign (float): +1 or -1 depending on the sign of the derivative in the curl.
+    """
+
+    def __init__(self, target, plus, minus, coefficient, b, a, kappa_factor, sign):
+        self.target = target
+        self.plus, self.minus = plus, minus
+        self.coefficient = coefficient
+        self.b, self.a, self.kappa_factor = b, a, kappa_factor
+        self.sign = sign
+
+        self.psi = numpy.zeros(target.shape, dtype=target.dtype)
+        self.difference = numpy.empty(target.shape, dtype=target.dtype)
+        self.scratch = numpy.empty(target.shape, dtype=target.dtype)
+
+    def update(self) -> NoReturn:
+        """Advance the auxiliary array and correct the target field in place."""
+        numpy.subtract(self.plus, self.minus, out=self.difference)
+
+        numpy.multiply(self.psi, self.b, out=self.psi)
+        numpy.multiply(self.difference, self.a, out=self.scratch)
+        numpy.add(self.psi, self.scratch, out=self.psi)
+
+        numpy.multiply(self.difference, self.kappa_factor, out=self.difference)
+        numpy.add(self.difference, self.psi, out=self.difference)
+        numpy.multiply(self.difference, self.coefficient, out=self.difference)
+
+        if self.sign > 0:
+            numpy.add(self.target, self.difference, out=self.target)
+        else:
+            numpy.subtract(self.target, self.difference, out=self.target)
+
+
+@dataclass(config=config_dict)
+class CPML():
+    """
+    Convolutional (CFS) perfectly matched layer.
+
+    Unlike :class:`PML`, nothing is stored over the whole grid: the graded
+    profiles are 1D and the auxiliary psi arrays live on the four boundary
+    slabs only, so memory and per-step work scale with perimeter x width.
+    The complex frequency shift (kappa, alpha) improves absorption of
+    grazing and evanescent waves, which allows thinner layers.
+    """
+    grid: Grid
+    """ The grid of the simulation mesh """
+    width: int = 10
+    """ Width of the PML region in cells """
+    order: int = 3
+    """ Polynomial order of the grading """
+    sigma_max: Optional[float] = None
+    """ Maximum conductivity [S/m], defaults to the optimal 0.8 (order + 1) / (eta_0 * dx) """
+    kappa_max: float = 5.0
+    """ Maximum real coordinate stretching """
+    alpha_max: float = 0.0
+    """ Maximum complex frequency shift [S/m], decreasing linearly into the layer """
+
+    def __post_init__(self):
+        assert 0 < self.width < min(self.grid.n_x, self.grid.n_y) // 2, f"Invalid PML width: {self.width}, it must be positive and smaller than half the grid."
+
+        if self.sigma_max is None:
+            eta_0 = numpy.sqrt(Physics.mu_0 / Physics.epsilon_0)
+            self.sigma_max = 0.8 * (self.order + 1) / (eta_0 * min(self.grid.dx, self.grid.dy))
+
+        self.sigma_x, _, _ = self.get_profile(n=self.grid.n_x, offset=0)
+        self.sigma_y, _, _ = self.get_profile(n=self.grid.n_y, offset=0)
+
+    def get_profile(self, n: int, offset: float) -> Tuple[numpy.ndarray, numpy.ndarray, numpy.ndarray]:
+        """
+        Graded sigma, kappa and alpha along an axis.
+
+        Args:
+            n (int): Number of cells along the axis.
+            offset (float): 0 for Ez nodes, 0.5 for the staggered H nodes.
+
+        Returns:
+            tuple: sigma, kappa and alpha profiles.
+        """
+        depth = get_graded_depth(n=n, width=self.width, offset=offset)
+        grading = get_grading(n=n, width=self.width, order=self.order, offset=offset)
+
+        sigma = self.sigma_max * grading
+        kappa = 1 + (self.kappa_max - 1) * grading
+        alpha = self.alpha_max * (1 - depth) * (depth > 0)
+
+        return sigma, kappa, alpha
+
+    def get_recursive_coefficients(self, n: int, offset: float) -> Tuple[numpy.ndarray, numpy.ndarray, numpy.ndarray]:
+        """
+        Recursive convolution coefficients b, a and 1 / kappa - 1 along an axis.
+
+        Args:
+            n (int): Number of cells along the axis.
+            offset (float): 0 for Ez nodes, 0.5 for the staggered H nodes.
+
+        Returns:
+            tuple: b, a and kappa_factor profiles.
+        """
+        sigma, kappa, alpha = self.get_profile(n=n, offset=offset)
+
+        b = numpy.exp(-(sigma / kappa + alpha) * self.grid.dt / Physics.epsilon_0)
+
+        denominator = sigma * kappa + kappa**2 * alpha
+        a = numpy.divide(sigma * (b - 1), denominator, out=numpy.zeros(n), where=denominator > 0)
+
+        return b, a, 1 / kappa - 1
+
+    def initialize(
+            self,
+            Ez: numpy.ndarray,
+            Hx: numpy.ndarray,
+            Hy: numpy.ndarray,
+            coefficients,
+            owned_rows: Optional[Tuple[int, int]] = None,
+            row_offset: int = 0) -> NoReturn:
+        """
+        Bind the boundary slabs to the fields and update coefficients of a run.
+
+        The fields may hold a band of rows of the grid only (one slab of a
+        domain decomposition), in which case only the part of the boundary
+        layers lying in the owned rows is updated. The rows right outside the
+        owned band are read as halo when they exist.
+
+        Args:
+            Ez (numpy.ndarray): The Ez field.
+            Hx (numpy.ndarray): The Hx field.
+            Hy (numpy.ndarray): The Hy field.
+            coefficients (UpdateCoefficients): The bulk update coefficients, indexed like the fields.
+            owned_rows (tuple): Grid rows (start, stop) updated by this instance, default is the whole grid.
+            row_offset (int): Grid row of the first row of the fields (default is 0).
+        """
+        w, n_x, n_y = self.width, self.grid.n_x, self.grid.n_y
+        c = coefficients
+        owned_start, owned_stop = (0, n_x) if owned_rows is None else owned_rows
+
+        def clip(rows: slice) -> Tuple[slice, slice]:
+            """Restrict grid rows to the owned band, returns the (local, grid) slices or None if empty."""
+            start, stop = max(rows.start, owned_start), min(rows.stop, owned_stop)
+            if start >= stop:
+                return None
+            return slice(start - row_offset, stop - row_offset), slice(start, stop)
+
+        self.magnetic_slabs, self.electric_slabs = [], []
+
+        # x-normal slabs: dEz/dx drives Hy, dHy/dx drives Ez
+        b_h, a_h, k_h = (p[:, None].astype(Ez.dtype) for p in self.get_recursive_coefficients(n=n_x, offset=0.5))
+        b_e, a_e, k_e = (p[:, None].astype(Ez.dtype) for p in self.get_recursive_coefficients(n=n_x, offset=0))
+
+        for band in [clip(slice(0, w)), clip(slice(n_x - w - 1, n_x - 1))]:
+            if band is None:
+                continue
+            rows, grid_rows = band
+            plus = slice(rows.start + 1, rows.stop + 1)
+            self.magnetic_slabs.append(
+                CPMLSlab(Hy[rows], Ez[plus], Ez[rows], c.Db_y[rows], b_h[grid_rows], a_h[grid_rows], k_h[grid_rows], sign=+1)
+            )
+
+        for band in [clip(slice(1, w)), clip(slice(n_x - w, n_x - 1))]:
+            if band is None:
+                continue
+            rows, grid_rows = band
+            minus = slice(rows.start - 1, rows.stop - 1)
+            self.electric_slabs.append(
+                CPMLSlab(Ez[rows, 1:-1], Hy[rows, 1:-1], Hy[minus, 1:-1], c.Cb_x[rows, 1:-1], b_e[grid_rows], a_e[grid_rows], k_e[grid_rows], sign=+1)
+            )
+
+        # y-normal slabs: dEz/dy drives Hx, dHx/dy drives Ez
+        b_h, a_h, k_h = (p[None, :].astype(Ez.dtype) for p in self.get_recursive_coefficients(n=n_y, offset=0.5))
+        b_e, a_e, k_e = (p[None, :].astype(Ez.dtype) for p in self.get_recursive_coefficients(n=n_y, offset=0))
+
+        magnetic_band = clip(slice(0, n_x))
+        electric_band = clip(slice(1, n_x - 1))
+
+        for cols in [slice(0, w), slice(n_y - w - 1, n_y - 1)]:
+            if magnetic_band is None:
+                continue
+            rows, _ = magnetic_band
+            plus = slice(cols.start + 1, cols.stop + 1)
+            self.magnetic_slabs.append(
+                CPMLSlab(Hx[rows, cols], Ez[rows, plus], Ez[rows, cols], c.Db_x[rows, cols], b_h[:, cols], a_h[:, cols], k_h[:, cols], sign=-1)
+            )
+
+        for cols in [slice(1, w), slice(n_y - w, n_y - 1)]:
+            if electric_band is None:
+                continue
+            rows, _ = electric_band
+            minus = slice(cols.start - 1, cols.stop - 1)
+            self.electric_slabs.append(
+                CPMLSlab(Ez[rows, cols], Hx[rows, cols], Hx[rows, minus], c.Cb_y[rows, cols], b_e[:, cols], a_e[:, cols], k_e[:, cols], sign=-1)
+            )
+
+    def update_magnetic(self) -> NoReturn:
+        """Apply the CPML correction after the bulk H update."""
+        for slab in self.magnetic_slabs:
+            slab.update()
+
+    def update_electric(self) -> NoReturn:
+        """Apply the CPML correction after the bulk Ez update."""
+        for slab in self.electric_slabs:
+            slab.update()
+
+    def add_to_ax(self, ax: plt.axis) -> NoReturn:
+        cmap = numpy.zeros([256, 4])
+        cmap[:, 3] = numpy.linspace(0, 1, 256)
+        cmap = ListedColormap(cmap)
+
+        ax.pcolormesh(
+            self.grid.x_stamp,
+            self.grid.y_stamp,
+            self.sigma_y[:, None] + self.sigma_x[None, :],
+            cmap=cmap,
+        )
+
+    def plot(self, unit_size: int = 6) -> NoReturn:
+        figsize = int(unit_size), int(unit_size * self.grid.size_y / self.grid.size_x)
+        figure, ax = plt.subplots(1, 1, figsize=figsize)
+
+        ax.set_title('Convolutional PML profile')
+        ax.set_ylabel(r'y position [$\mu$m]')
+        ax.set_xlabel(r'x position [$\mu$m]')
+        ax.set_aspect('equal')
+
+        self.add_to_ax(ax)
+
+        plt.show()
+
 # -
@@ -0,0 +1,135 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+from typing import NoReturn, Optional, Union, List, Tuple
+import numpy
+from LightWave2D.grid import Grid
+from pydantic.dataclasses import dataclass
+
+config_dict = dict(
+    kw_only=True,
+    slots=True,
+    extra='forbid',
+    arbitrary_types_allowed=True
+)
+
+
+@dataclass(config=config_dict)
+class Recording:
+    """
+    Policy deciding which Ez frames, and which part of them, are kept by Experiment.run_fdtd.
+
+    Only the selected frames over the selected region are allocated, so
+    detector-only runs can use ``Recording(every=None)`` and keep no history
+    at all.
+
+    Attributes:
+        every (Optional[int]): Keep one frame every `every` time steps, None to keep none (default is 1, i.e. all frames).
+        frames (Optional[List[int]]): Explicit list of time step indices to keep, negative values count from the end. Overrides `every`.
+        region (Optional[Tuple]): Two corners ((x0, y0), (x1, y1)) of the recorded region of interest, default is the whole grid.
+    """
+    every: Optional[int] = 1
+    frames: Optional[List[int]] = None
+    region: Optional[Tuple[Tuple[Union[float, str], Union[float, str]], Tuple[Union[float, str], Union[float, str]]]] = None
+
+    def initialize(self, grid: Grid, dtype: numpy.dtype = numpy.float64, batch_shape: Tuple[int, ...] = ()) -> NoReturn:
+        """
+        Allocate the frame buffer for a given grid.
+
+        Args:
+            grid (Grid): The grid of the simulation mesh.
+            dtype (numpy.dtype): Floating point type of the stored frames (default is float64).
+            batch_shape (tuple): Leading axes of a stacked field, the frames are then of shape (*batch_shape, n_x, n_y) (default is ()).
+        """
+        self.grid = grid
+
+        if self.frames is not None:
+            frames = numpy.asarray(self.frames, dtype=int)
+            if numpy.any((frames < -grid.n_steps) | (frames >= grid.n_steps)):
+                raise ValueError(f"Invalid recording frames: {self.frames}, they must lie in [-{grid.n_steps}, {grid.n_steps}).")
+            frame_indices = numpy.unique(frames % grid.n_steps)
+        elif self.every is not None:
+            assert self.every > 0, f"Invalid recording interval: {self.every}, it must be positive."
+            frame_indices = numpy.arange(0, grid.n_steps, self.every)
+        else:
+            frame_indices = numpy.arange(0)
+
+        self.frame_indices = frame_indices
+        self.time_stamp = grid.time_stamp[frame_indices]
+
+        self.slot = numpy.full(grid.n_steps, -1, dtype=int)
+        self.slot[frame_indices] = numpy.arange(frame_indices.size)
+
+        self.x_slice, self.y_slice = self.get_region_slices()
+        self.x_stamp = grid.x_stamp[self.x_slice]
+        self.y_stamp = grid.y_stamp[self.y_slice]
+
+        self.data = numpy.zeros((frame_indices.size, *batch_shape, self.x_stamp.size, self.y_stamp.size), dtype=dtype)
+
+    def get_region_slices(self) -> Tuple[slice, slice]:
+        """
+        Convert the region of interest into index slices of the grid.
+
+        Returns:
+            tuple: Slices along x and y.
+        """
+        if self.region is None:
+            return slice(None), slice(None)
+
+        (x0, y0), (x1, y1) = self.region
+        p0 = self.grid.get_coordinate(x=x0, y=y0)
+        p1 = self.grid.get_coordinate(x=x1, y=y1)
+
+        x_start, x_stop = sorted([p0.x_index, p1.x_index])
+        y_start, y_stop = sorted([p0.y_index, p1.y_index])
+
+        return slice(x_start, x_stop + 1), slice(y_start, y_stop + 1)
+
+    def record(self, iteration: int, field: numpy.ndarray) -> NoReturn:
+        """
+        Store the field if the given iteration is one of the recorded frames.
+
+        Args:
+            iteration (int): The current time step index.
+            field (numpy.ndarray): The Ez field at that time step, possibly stacked along leading axes.
+        """
+        slot = self.slot[iteration]
+        if slot >= 0:
+            self.data[slot] = field[..., self.x_slice, self.y_slice]
+
+    def truncate(self, n_steps: int) -> NoReturn:
+        """
+        Drop the frames past the end of a run stopped early.
+
+        Args:
+            n_steps (int): Number of time steps actually run.
+        """
+        n_frames = int(numpy.count_nonzero(self.frame_indices < n_steps))
+
+        self.frame_indices = self.frame_indices[:n_frames]
+        self.time_stamp = self.time_stamp[:n_frames]
+        self.data = self.data[:n_frames]
+
+
+def parse_recording(recording: Union[str, Recording]) -> Recording:
+    """
+    Normalize the recording argument of Experiment.run_fdtd.
+
+    Args:
+        recording (str | Recording): 'all', 'none' or a Recording instance.
+
+    Returns:
+        Recording: The corresponding policy.
+    """
+    if isinstance(recording, Recording):
+        return recording
+
+    assert recording in ['all', 'none'], f"Invalid recording: {recording}. Valid inputs are ['all', 'none'] or a Recording instance."
+
+    match recording:
+        case 'all':
+            return Recording(every=1)
+        case 'none':
+            return Recording(every=None)
+
+# -
@@ -2,7 +2,7 @@
 # -*- coding: utf-8 -*-
 
 import numpy
-from typing import Tuple, NoReturn, List, Union
+from typing import Tuple, NoReturn, List, Union, Optional, Literal
 from LightWave2D.utils import bresenham_line
 from pydantic.dataclasses import dataclass
 from matplotlib.path import Path
@@ -34,12 +34,14 @@ class BaseSource():
         angle (float): Rotation angle of the ellipse.
         facecolor (str): Color of the scatterer face.
         edgecolor (str): Color of the scatterer edge.
+        mode (str): 'hard' (default) overwrites Ez at the source cells, 'soft' adds to it so scattered light passes through the source.
     """
     grid: Grid
     facecolor: str = 'red'
     edgecolor: str = 'red'
     alpha: float = 0.3
     rotation: float = 0
+    mode: Literal['hard', 'soft'] = 'hard'
 
     def __post_init__(self):
         x0, y0 = self.position
@@ -63,6 +65,20 @@ class BaseSource():
 
         self.idx = self.path.contains_points(coordinates).astype(bool).reshape(self.epsilon_r_mesh.shape)
 
+    def write_to_field(self, field: numpy.ndarray, cells: tuple, value) -> NoReturn:
+        """
+        Overwrite (hard source) or increment (soft source) the field at the given cells.
+
+        Args:
+            field (numpy.ndarray): The simulation field.
+            cells (tuple): Row and column indices of the cells.
+            value (float | numpy.ndarray): The source value.
+        """
+        if self.mode == 'soft':
+            field[cells] += value
+        else:
+            field[cells] = value
+
     def add_to_ax(self, ax: plt.axis) -> PatchCollection:
         """
         Add the scatterer to the provided axis as a circle.
@@ -116,6 +132,7 @@ class PointSource(BaseSource):
         self.omega = 2 * numpy.pi * self.frequency
         x, y = self.position
         self.p0 = self.grid.get_coordinate(x=x, y=y)
+        self.flat_index = numpy.ravel_multi_index(([self.p0.x_index], [self.p0.y_index]), self.grid.shape)
         self.polygon = geo.Point(self.p0.x, self.p0.y)
         self.path = Path(self.polygon.coords)
 
@@ -141,29 +158,52 @@ class PointSource(BaseSource):
             field (numpy.ndarray): The simulation field to which the source's effect will be added.
             time (float): The current simulation time.
         """
-        field[self.p0.x_index, self.p0.y_index] = self.amplitude / len(self.omega) * numpy.sin(self.omega * time).sum()
+        value = self.amplitude / len(self.omega) * numpy.sin(self.omega * time).sum()
+
+        self.write_to_field(field, (self.p0.x_index, self.p0.y_index), value)
+
+    def get_waveform(self, time: numpy.ndarray) -> numpy.ndarray:
+        """
+        Values written by the source at the given times, identical to the ones of `add_source_to_field`.
+
+        Args:
+            time (numpy.ndarray): The simulation times.
+
+        Returns:
+            numpy.ndarray: Array of shape (n_times, 1), broadcastable to (n_times, n_cells).
+        """
+        return self.amplitude / len(self.omega) * numpy.sin(numpy.multiply.outer(time, self.omega)).sum(axis=-1, keepdims=True)
 
 
 @dataclass(kw_only=True, config=config_dict)
 class Impulsion(BaseSource):
     """
-    Represents a point source in a 2D light wave simulation.
+    Represents a Gaussian pulse at a point in a 2D light wave simulation.
+
+    The waveform is ``amplitude * exp(-((t - delay) / duration)**2)``,
+    multiplied by the carrier ``sin(omega (t - delay))`` when a wavelength
+    is given, which moves the spectrum of the pulse from zero frequency to
+    the carrier frequency.
 
     Attributes:
-        wavelength (float): Wavelength of the source.
+        duration (float): Width of the Gaussian envelope [s].
         position (tuple): Position (x, y) of the source.
+        delay (float): Time of the envelope peak and phase origin of the carrier [s] (default is 0).
         amplitude (float): Amplitude of the electric field, default is 1.0.
+        wavelength (float): Wavelength of the carrier, None (default) for a carrier-less pulse.
     """
     duration: float
     position: Tuple[float | str, float | str]
     delay: float = 0
     amplitude: float = 1.0
+    wavelength: Optional[float] = None
     facecolor: str = 'red'
     edgecolor: str = 'red'
 
     def __post_init__(self):
         x, y = self.position
         self.p0 = self.grid.get_coordinate(x=x, y=y)
+        self.flat_index = numpy.ravel_multi_index(([self.p0.x_index], [self.p0.y_index]), self.grid.shape)
         self.polygon = geo.Point(self.p0.x, self.p0.y)
         self.path = Path(self.polygon.coords)
 
@@ -189,9 +229,25 @@ class Impulsion(BaseSource):
             field (numpy.ndarray): The simulation field to which the source's effect will be added.
             time (float): The current simulation time.
         """
-        source_field = numpy.exp(-((time - self.delay) / self.duration) ** 2)
+        self.write_to_field(field, (self.p0.x_index, self.p0.y_index), self.get_waveform(numpy.asarray([time]))[0, 0])
+
+    def get_waveform(self, time: numpy.ndarray) -> numpy.ndarray:
+        """
+        Values written by the source at the given times, identical to the ones of `add_source_to_field`.
+
+        Args:
+            time (numpy.ndarray): The simulation times.
+
+        Returns:
+            numpy.ndarray: Array of shape (n_times, 1), broadcastable to (n_times, n_cells).
+        """
+        time = numpy.asarray(time) - self.delay
+        source_field = numpy.exp(-(time / self.duration) ** 2)
 
-        field[self.p0.x_index, self.p0.y_index] = self.amplitude * source_field
+        if self.wavelength is not None:
+            source_field *= numpy.sin(2 * numpy.pi * Physics.c / self.wavelength * time)
+
+        return (self.amplitude * source_field)[:, None]
 
 
 @dataclass(kw_only=True, config=config_dict)
@@ -231,6 +287,7 @@ class LineSource(BaseSource):
 
         rows, cols = zip(*position.T)
         self.slice_indexes = rows, cols
+        self.flat_index = numpy.ravel_multi_index((rows, cols), self.grid.shape)
 
         p0 = geo.Point(self.p0.x, self.p0.y)
         p1 = geo.Point(self.p1.x, self.p1.y)
@@ -258,5 +315,125 @@ class LineSource(BaseSource):
             field (numpy.ndarray): The simulation field to which the source's effect will be added.
             time (float): The current simulation time.
         """
-        rows, cols = self.slice_indexes
-        field[rows, cols] = self.amplitude * numpy.sin(self.omega * time)
+        self.write_to_field(field, self.slice_indexes, self.amplitude * numpy.sin(self.omega * time))
+
+    def get_waveform(self, time: numpy.ndarray) -> numpy.ndarray:
+        """
+        Values written by the source at the given times, identical to the ones of `add_source_to_field`.
+
+        Args:
+            time (numpy.ndarray): The simulation times.
+
+        Returns:
+            numpy.ndarray: Array of shape (n_times, 1), broadcastable to (n_times, n_cells).
+        """
+        return (self.amplitude * numpy.sin(self.omega * numpy.asarray(time)))[:, None]
+
+
+class SourceTable:
+    """
+    Waveforms of all the sources precomputed over the time stamps, injected with a single scatter per time step.
+
+    Each source contributes one column to the (n_times, n_waveform) table,
+    evaluated once with its `get_waveform`, and its cells to a merged index
+    set. At every step the row of the current time is gathered onto the cells
+    and written into the field with one `numpy.put` for the hard sources and
+    one `numpy.add.at` for the soft ones, so the cost does not depend on the
+    number of sources. The result is the one of sequential calls to
+    `add_source_to_field`: where a hard source writes a cell, only its last
+    write and the soft sources after it in injection order are kept.
+
+    Args:
+        sources (list): The sources, in injection order.
+        time (numpy.ndarray): The simulation times.
+        dtype (numpy.dtype): Floating point type of the field the values are written to.
+        index_offsets (list): Offset added to the flat indices of every source, e.g. to address one variant of a stacked batch.
+    """
+
+    def __init__(self, sources: list, time: numpy.ndarray, dtype: numpy.dtype = numpy.float64, index_offsets: Optional[List[int]] = None):
+        if index_offsets is None:
+            index_offsets = [0] * len(sources)
+
+        self.waveforms = numpy.zeros((numpy.size(time), len(sources)), dtype=dtype)
+        for column, source in enumerate(sources):
+            self.waveforms[:, column] = source.get_waveform(time)[:, 0]
+
+        if sources:
+            index = numpy.concatenate([source.flat_index + offset for source, offset in zip(sources, index_offsets)])
+            column = numpy.concatenate([numpy.full(source.flat_index.size, n) for n, source in enumerate(sources)])
+            is_soft = numpy.concatenate([numpy.full(source.flat_index.size, source.mode == 'soft') for source in sources])
+        else:
+            index, column, is_soft = numpy.arange(0), numpy.arange(0), numpy.zeros(0, dtype=bool)
+
+        index, column = index.astype(numpy.intp), column.astype(numpy.intp)
+        order = numpy.arange(index.size)
+
+        # Keep the last hard write of every cell.
+        hard_order = order[~is_soft]
+        hard_cells, last = numpy.unique(index[hard_order][::-1], return_index=True)
+        last_hard = hard_order[hard_order.size - 1 - last]
+
+        # Drop the soft increments overwritten by a later hard write.
+        soft_order = order[is_soft]
+        overwritten = numpy.zeros(soft_order.size, dtype=bool)
+        if hard_cells.size:
+            position = numpy.minimum(numpy.searchsorted(hard_cells, index[soft_order]), hard_cells.size - 1)
+            overwritten = (hard_cells[position] == index[soft_order]) & (last_hard[position] > soft_order)
+
+        hard = numpy.sort(last_hard)
+        soft = soft_order[~overwritten]
+
+        self.index, self.column = index[hard], column[hard]
+        self.soft_index, self.soft_column = index[soft], column[soft]
+        self.allocate_buffers()
+
+    def allocate_buffers(self) -> NoReturn:
+        """Allocate the per-step gather buffers of the hard and soft cells."""
+        self.values = numpy.empty(self.index.size, dtype=self.waveforms.dtype)
+        self.soft_values = numpy.empty(self.soft_index.size, dtype=self.waveforms.dtype)
+
+    @property
+    def has_soft(self) -> bool:
+        return bool(self.soft_index.size)
+
+    def restrict(self, owned_rows: Tuple[int, int], row_offset: int, n_y: int) -> NoReturn:
+        """
+        Keep the cells of a band of rows only and index them in a local field holding the rows from `row_offset` on.
+
+        Args:
+            owned_rows (tuple): Grid rows (start, stop) to keep.
+            row_offset (int): Grid row of the first row of the local field.
+            n_y (int): Number of columns of the grid.
+        """
+        def localize(index, column):
+            rows = index // n_y
+            owned = (rows >= owned_rows[0]) & (rows < owned_rows[1])
+            return index[owned] - row_offset * n_y, column[owned]
+
+        self.index, self.column = localize(self.index, self.column)
+        self.soft_index, self.soft_column = localize(self.soft_index, self.soft_column)
+        self.allocate_buffers()
+
+    def get_cell_values(self) -> numpy.ndarray:
+        """
+        Values written at every cell of `index` by the hard sources, as a C-contiguous (n_times, n_cells) array.
+        """
+        return numpy.ascontiguousarray(self.waveforms[:, self.column])
+
+    def inject(self, field: numpy.ndarray, iteration: int) -> NoReturn:
+        """
+        Write the values of all the sources at one time step into the field.
+
+        Args:
+            field (numpy.ndarray): The C-contiguous Ez field.
+            iteration (int): The current time step index.
+        """
+        if self.index.size:
+            numpy.take(self.waveforms[iteration], self.column, out=self.values)
+            numpy.put(field, self.index, self.values)
+
+        if self.soft_index.size:
+            numpy.take(self.waveforms[iteration], self.soft_column, out=self.soft_values)
+            numpy.add.at(field.reshape(-1), self.soft_index, self.soft_values)
+
+# -
@@ -0,0 +1,231 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+import copy
+from typing import NoReturn, Optional, Tuple, Union, List
+import numpy
+from LightWave2D.physics import Physics
+from LightWave2D.experiment import Experiment
+from LightWave2D.detector import FrequencyMonitor
+import matplotlib.pyplot as plt
+
+
+class TransmissionSpectrum:
+    """
+    Broadband transmission and reflection spectra of a device from a single pulsed run.
+
+    A soft Impulsion, whose carrier is at the centre frequency of the band
+    and whose Gaussian width is chosen so that its spectrum stays above
+    `minimum_amplitude` of its peak over the whole band, is injected at
+    `source_position`. A single wavelength is given a band of +/- 10 % of
+    its frequency. Frequency monitors on two adjacent rows
+    (or columns) of cells along the input and output lines give Ez and,
+    from their difference, the tangential H, hence the Poynting flux through
+    the lines at every wavelength of the band.
+
+    The spectra are normalized by a reference run (by default the experiment
+    without its components, typically a straight waveguide is given instead)
+    which measures the incident flux through the input line. The reflected
+    field is the device field minus the reference field on the input line.
+    With the same grid, the reference run is made once and reused by every
+    device passed to `run`, so a whole spectrum costs one simulation per
+    device instead of one per wavelength.
+
+    The lines must be horizontal or vertical, with the source on the side of
+    the input line opposite to the device. The sources, detectors and plane
+    wave of the experiments are ignored, the runs are made on copies.
+
+    Args:
+        experiment (Experiment): The device.
+        wavelength (float | List[float] | numpy.ndarray): Wavelengths of the spectra.
+        source_position (Tuple[float | str, float | str]): Position of the pulse.
+        input_line (Tuple): Two points ((x0, y0), (x1, y1)) of the input line, between the source and the device.
+        output_line (Tuple): Two points ((x0, y0), (x1, y1)) of the output line, after the device.
+        reference (Experiment): The normalization experiment on the same grid, default is `experiment` without its components.
+        minimum_amplitude (float): Lowest relative amplitude of the pulse spectrum in the band (default is 1e-2).
+    """
+
+    def __init__(
+            self,
+            experiment: Experiment,
+            wavelength: Union[float, List[float], numpy.ndarray],
+            source_position: Tuple[float | str, float | str],
+            input_line: Tuple,
+            output_line: Tuple,
+            reference: Optional[Experiment] = None,
+            minimum_amplitude: float = 1e-2):
+
+        self.experiment = experiment
+        self.grid = experiment.grid
+        self.wavelength = numpy.atleast_1d(wavelength).astype(float)
+        self.omega = 2 * numpy.pi * Physics.c / self.wavelength
+        self.source_position = source_position
+        self.input_line = input_line
+        self.output_line = output_line
+
+        if reference is None:
+            reference = copy.deepcopy(experiment)
+            reference.components = []
+
+        self.check_grid(reference)
+        self.reference = reference
+
+        # The spectrum of sin(omega_c t) exp(-(t / duration)**2) is proportional to exp(-((omega - omega_c) duration / 2)**2)
+        # around omega_c, so the band edges at +/- half_width are reached at minimum_amplitude.
+        center = (self.omega.max() + self.omega.min()) / 2
+        half_width = max((self.omega.max() - self.omega.min()) / 2, 0.1 * center)
+
+        self.carrier_wavelength = 2 * numpy.pi * Physics.c / center
+        self.duration = 2 * numpy.sqrt(numpy.log(1 / minimum_amplitude)) / half_width
+        self.delay = 4 * self.duration
+
+        if self.delay + 4 * self.duration > self.grid.time_stamp[-1]:
+            raise ValueError("The run is too short to contain the pulse, increase n_steps.")
+
+        self.reference_input = None
+        self.reference_output = None
+        self.transmission = None
+        self.reflection = None
+
+    def check_grid(self, experiment: Experiment) -> NoReturn:
+        """
+        Raise a ValueError if the experiment is not on the same grid as the analysed one.
+        """
+        grid = experiment.grid
+        if grid.shape != self.grid.shape or grid.n_steps != self.grid.n_steps or grid.dt != self.grid.dt:
+            raise ValueError("The experiments of a transmission spectrum must share the same grid.")
+
+    def is_vertical(self, line: Tuple) -> bool:
+        """
+        Whether a line is vertical (True) or horizontal (False).
+
+        Args:
+            line (Tuple): The two points of the line.
+        """
+        p0 = self.grid.get_coordinate(x=line[0][0], y=line[0][1])
+        p1 = self.grid.get_coordinate(x=line[1][0], y=line[1][1])
+
+        if p0.x_index == p1.x_index:
+            return True
+        if p0.y_index == p1.y_index:
+            return False
+
+        raise ValueError("The lines of a transmission spectrum must be horizontal or vertical.")
+
+    def get_line_monitor(self, experiment: Experiment, line: Tuple) -> FrequencyMonitor:
+        """
+        Add a monitor covering the cells of a line and the next row or column of cells.
+
+        Args:
+            experiment (Experiment): The experiment receiving the monitor.
+            line (Tuple): The two points of the line.
+
+        Returns:
+            FrequencyMonitor: The region monitor, of spatial shape (2, n) for a vertical line and (n, 2) for a horizontal one.
+        """
+        p0 = self.grid.get_coordinate(x=line[0][0], y=line[0][1])
+        p1 = self.grid.get_coordinate(x=line[1][0], y=line[1][1])
+
+        # Corners are given at cell centres so that they map back to the intended indices.
+        x_0, y_0 = (p0.x_index + 0.5) * self.grid.dx, (p0.y_index + 0.5) * self.grid.dy
+
+        if self.is_vertical(line):
+            corner = ((p0.x_index + 1.5) * self.grid.dx, (p1.y_index + 0.5) * self.grid.dy)
+        else:
+            corner = ((p1.x_index + 0.5) * self.grid.dx, (p0.y_index + 1.5) * self.grid.dy)
+
+        return experiment.add_frequency_monitor(wavelength=self.wavelength, region=((x_0, y_0), corner))
+
+    def get_flux(self, field: numpy.ndarray, vertical: bool) -> numpy.ndarray:
+        """
+        Poynting flux through a line from the transformed Ez on its two rows of cells.
+
+        The flux is counted positive toward +x for a vertical line and toward +y for a horizontal one.
+
+        Args:
+            field (numpy.ndarray): Monitor data of shape (n_wavelength, 2, n) or (n_wavelength, n, 2).
+            vertical (bool): Whether the line is vertical.
+
+        Returns:
+            numpy.ndarray: Flux per unit length along z at every wavelength, up to a constant factor.
+        """
+        omega = self.omega[:, None]
+
+        if vertical:
+            Ez = (field[:, 0] + field[:, 1]) / 2
+            Hy = (field[:, 1] - field[:, 0]) / (1j * omega * Physics.mu_0 * self.grid.dx)
+            return -numpy.sum(Ez * Hy.conj(), axis=-1).real * self.grid.dy
+
+        Ez = (field[:, :, 0] + field[:, :, 1]) / 2
+        Hx = -(field[:, :, 1] - field[:, :, 0]) / (1j * omega * Physics.mu_0 * self.grid.dy)
+        return numpy.sum(Ez * Hx.conj(), axis=-1).real * self.grid.dx
+
+    def get_line_field(self, experiment: Experiment, **kwargs) -> Tuple[numpy.ndarray, numpy.ndarray]:
+        """
+        Run a copy of the experiment driven by the pulse and return the transformed Ez on the input and output lines.
+
+        Args:
+            experiment (Experiment): The experiment to run.
+            kwargs: Extra arguments of `run_fdtd` (e.g. backend, stop_criteria).
+        """
+        pulsed_run = copy.deepcopy(experiment)
+        pulsed_run.sources = []
+        pulsed_run.detectors = []
+        pulsed_run.plane_wave = None
+
+        pulsed_run.add_impulsion(
+            position=self.source_position,
+            duration=self.duration,
+            delay=self.delay,
+            wavelength=self.carrier_wavelength,
+            mode='soft'
+        )
+        input_monitor = self.get_line_monitor(pulsed_run, self.input_line)
+        output_monitor = self.get_line_monitor(pulsed_run, self.output_line)
+
+        pulsed_run.run_fdtd(recording='none', **kwargs)
+
+        return input_monitor.data, output_monitor.data
+
+    def run(self, experiment: Optional[Experiment] = None, **kwargs) -> Tuple[numpy.ndarray, numpy.ndarray]:
+        """
+        Compute the spectra of a device, running the reference first if not done yet.
+
+        Args:
+            experiment (Experiment): The device, default is the experiment of the analysis. Any device on the same grid reuses the reference run.
+            kwargs: Extra arguments of `run_fdtd` (e.g. backend, stop_criteria).
+
+        Returns:
+            tuple: The transmission and reflection at every wavelength, also stored in `transmission` and `reflection`.
+        """
+        experiment = self.experiment if experiment is None else experiment
+        self.check_grid(experiment)
+
+        if self.reference_input is None:
+            self.reference_input, self.reference_output = self.get_line_field(self.reference, **kwargs)
+
+        device_input, device_output = self.get_line_field(experiment, **kwargs)
+
+        input_vertical, output_vertical = self.is_vertical(self.input_line), self.is_vertical(self.output_line)
+        incident_flux = self.get_flux(self.reference_input, vertical=input_vertical)
+
+        self.transmission = abs(self.get_flux(device_output, vertical=output_vertical)) / incident_flux
+        self.reflection = -self.get_flux(device_input - self.reference_input, vertical=input_vertical) / incident_flux
+
+        return self.transmission, self.reflection
+
+    def plot(self) -> NoReturn:
+        """
+        Plot the transmission and reflection spectra.
+        """
+        assert self.transmission is not None, "No spectrum computed, call run first."
+
+        figure, ax = plt.subplots(1, 1)
+        ax.plot(self.wavelength, self.transmission, 'o-', label='transmission')
+        ax.plot(self.wavelength, self.reflection, 'o-', label='reflection')
+        ax.set_xlabel('Wavelength [m]')
+        ax.set_ylabel('Normalized power')
+        ax.legend()
+        plt.show()
+
+# -
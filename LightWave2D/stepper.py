@@ -0,0 +1,202 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+from typing import NoReturn, Optional, Tuple
+import numpy
+from LightWave2D.physics import Physics
+from LightWave2D.grid import Grid
+from LightWave2D.decomposition import ThreadedStepper
+
+
+class UpdateCoefficients:
+    """
+    Per-cell coefficients of the TMz leapfrog, assembled once before the time loop.
+
+    Every array has the shape of the permittivity mesh, the full grid or a band
+    of its rows, so the steppers can slice them exactly like the fields they
+    multiply:
+
+        - ``Db_x`` multiplies ``Ez[i, j + 1] - Ez[i, j]`` in the Hx update.
+        - ``Db_y`` multiplies ``Ez[i + 1, j] - Ez[i, j]`` in the Hy update.
+        - ``Cb_x`` multiplies ``Hy[i, j] - Hy[i - 1, j]`` in the Ez update.
+        - ``Cb_y`` multiplies ``Hx[i, j] - Hx[i, j - 1]`` in the Ez update.
+        - ``Ca`` is the PML damping factor applied to Ez after the curl update.
+
+    The scheme has no decay term on H, so the usual ``Da`` coefficient is
+    identically one and is not stored.
+
+    Args:
+        grid (Grid): The grid of the simulation mesh.
+        sigma_x (numpy.ndarray): PML conductivity along x.
+        sigma_y (numpy.ndarray): PML conductivity along y.
+        epsilon (numpy.ndarray): Absolute permittivity mesh.
+        dtype (numpy.dtype): Floating point type of the stored coefficients, they are always computed in double precision (default is float64).
+    """
+
+    def __init__(self, grid: Grid, sigma_x: numpy.ndarray, sigma_y: numpy.ndarray, epsilon: numpy.ndarray, dtype: numpy.dtype = numpy.float64):
+        mu_factor = grid.dt / Physics.mu_0
+        eps_factor = grid.dt / epsilon
+
+        self.shape = numpy.shape(epsilon)
+        self.dtype = numpy.dtype(dtype)
+        self.Db_x = self._assemble(mu_factor / grid.dy * (1 - sigma_y * mu_factor / 2))
+        self.Db_y = self._assemble(mu_factor / grid.dx * (1 - sigma_x * mu_factor / 2))
+        self.Cb_x = self._assemble(eps_factor / grid.dx)
+        self.Cb_y = self._assemble(eps_factor / grid.dy)
+        self.Ca = self._assemble(1 - (sigma_x + sigma_y) * eps_factor / 2)
+
+        self.has_damping = bool(numpy.any(self.Ca != 1))
+
+    @classmethod
+    def stack(cls, coefficients: list) -> 'UpdateCoefficients':
+        """
+        Stack the coefficients of several variants sharing a grid along a leading batch axis.
+
+        Arrays identical across all the variants (typically the PML driven
+        Db terms) are kept as a single grid-shaped array which broadcasts
+        against the batch.
+
+        Args:
+            coefficients (list): The UpdateCoefficients of each variant.
+
+        Returns:
+            UpdateCoefficients: Coefficients of shape (n_variant, n_x, n_y) or broadcastable to it.
+        """
+        stacked = cls.__new__(cls)
+        stacked.shape = (len(coefficients), *coefficients[0].shape)
+        stacked.dtype = coefficients[0].dtype
+
+        for name in ['Db_x', 'Db_y', 'Cb_x', 'Cb_y', 'Ca']:
+            arrays = [getattr(c, name) for c in coefficients]
+            shared = all(numpy.array_equal(arrays[0], array) for array in arrays[1:])
+            setattr(stacked, name, arrays[0] if shared else numpy.stack(arrays))
+
+        stacked.has_damping = any(c.has_damping for c in coefficients)
+
+        return stacked
+
+    def _assemble(self, value: numpy.ndarray) -> numpy.ndarray:
+        """Materialize a (possibly broadcast) coefficient as a C-contiguous full-grid array."""
+        array = numpy.empty(self.shape, dtype=self.dtype)
+        array[...] = value
+        return array
+
+
+class NumpyStepper:
+    """
+    Reference TMz leapfrog stepper written with numpy slicing.
+
+    The stepper owns preallocated scratch buffers for the Yee differences and
+    writes every intermediate with ``out=``, so a time step does not allocate
+    any array. The leading axes of ``shape`` (if any) are treated as a batch
+    of independent fields sharing the same coefficients.
+
+    Args:
+        coefficients (UpdateCoefficients): The precomputed per-cell update coefficients.
+        shape (tuple): Shape of the stepped fields, defaults to the grid shape.
+    """
+
+    def __init__(self, coefficients: UpdateCoefficients, shape: Optional[Tuple[int, ...]] = None):
+        self.coefficients = coefficients
+        self.shape = coefficients.shape if shape is None else tuple(shape)
+
+        *batch, n_x, n_y = self.shape
+
+        dtype = coefficients.dtype
+
+        self.dEz_dx = numpy.empty((*batch, n_x - 1, n_y), dtype=dtype)
+        self.dEz_dy = numpy.empty((*batch, n_x, n_y - 1), dtype=dtype)
+        self.dHy_dx = numpy.empty((*batch, n_x - 2, n_y - 2), dtype=dtype)
+        self.dHx_dy = numpy.empty((*batch, n_x - 2, n_y - 2), dtype=dtype)
+
+        self.Db_x = coefficients.Db_x[..., :, :-1]
+        self.Db_y = coefficients.Db_y[..., :-1, :]
+        self.Cb_x = coefficients.Cb_x[..., 1:-1, 1:-1]
+        self.Cb_y = coefficients.Cb_y[..., 1:-1, 1:-1]
+
+    def update_magnetic(self, Ez: numpy.ndarray, Hx: numpy.ndarray, Hy: numpy.ndarray) -> NoReturn:
+        """Advance Hx and Hy by half a time step from the Yee gradient of Ez."""
+        dEz_dx, dEz_dy = self.dEz_dx, self.dEz_dy
+
+        numpy.subtract(Ez[..., :, 1:], Ez[..., :, :-1], out=dEz_dy)
+        numpy.multiply(self.Db_x, dEz_dy, out=dEz_dy)
+        Hx_view = Hx[..., :, :-1]
+        numpy.subtract(Hx_view, dEz_dy, out=Hx_view)
+
+        numpy.subtract(Ez[..., 1:, :], Ez[..., :-1, :], out=dEz_dx)
+        numpy.multiply(self.Db_y, dEz_dx, out=dEz_dx)
+        Hy_view = Hy[..., :-1, :]
+        numpy.add(Hy_view, dEz_dx, out=Hy_view)
+
+    def update_electric(self, Ez: numpy.ndarray, Hx: numpy.ndarray, Hy: numpy.ndarray) -> NoReturn:
+        """Advance Ez by half a time step from the curl of H."""
+        dHy_dx, dHx_dy = self.dHy_dx, self.dHx_dy
+
+        numpy.subtract(Hy[..., 1:-1, 1:-1], Hy[..., :-2, 1:-1], out=dHy_dx)
+        numpy.multiply(self.Cb_x, dHy_dx, out=dHy_dx)
+
+        numpy.subtract(Hx[..., 1:-1, 1:-1], Hx[..., 1:-1, :-2], out=dHx_dy)
+        numpy.multiply(self.Cb_y, dHx_dy, out=dHx_dy)
+
+        numpy.subtract(dHy_dx, dHx_dy, out=dHy_dx)
+        Ez_view = Ez[..., 1:-1, 1:-1]
+        numpy.add(Ez_view, dHy_dx, out=Ez_view)
+
+    def apply_damping(self, Ez: numpy.ndarray) -> NoReturn:
+        """Apply the PML damping to Ez."""
+        if self.coefficients.has_damping:
+            numpy.multiply(Ez, self.coefficients.Ca, out=Ez)
+
+    def close(self) -> NoReturn:
+        """Release the resources held by the stepper, nothing for a serial stepper."""
+
+    def __enter__(self) -> 'NumpyStepper':
+        return self
+
+    def __exit__(self, *exception) -> NoReturn:
+        self.close()
+
+
+class NativeStepper(NumpyStepper):
+    """
+    Same leapfrog as :class:`NumpyStepper`, delegated to the compiled
+    ``interface_yee`` module. The kernels update the fields in place,
+    release the GIL and split the rows across OpenMP threads.
+    """
+
+    def __init__(self, coefficients: UpdateCoefficients, shape: Optional[Tuple[int, ...]] = None):
+        if shape is not None and tuple(shape) != coefficients.shape:
+            raise ValueError("The native backend only steps a single field of the grid shape.")
+
+        try:
+            from LightWave2D.binary import interface_yee
+        except ImportError as error:
+            raise ImportError(
+                "The native backend is not available, LightWave2D was installed without its compiled extension. "
+                "Reinstall with a C++ compiler and pybind11 available or use backend='numpy'."
+            ) from error
+
+        self.coefficients = coefficients
+        self.shape = coefficients.shape
+        self.interface = interface_yee
+
+    def update_magnetic(self, Ez: numpy.ndarray, Hx: numpy.ndarray, Hy: numpy.ndarray) -> NoReturn:
+        c = self.coefficients
+        self.interface.update_magnetic(Ez=Ez, Hx=Hx, Hy=Hy, Db_x=c.Db_x, Db_y=c.Db_y)
+
+    def update_electric(self, Ez: numpy.ndarray, Hx: numpy.ndarray, Hy: numpy.ndarray) -> NoReturn:
+        c = self.coefficients
+        self.interface.update_electric(Ez=Ez, Hx=Hx, Hy=Hy, Cb_x=c.Cb_x, Cb_y=c.Cb_y)
+
+    def apply_damping(self, Ez: numpy.ndarray) -> NoReturn:
+        if self.coefficients.has_damping:
+            self.interface.apply_damping(Ez=Ez, Ca=self.coefficients.Ca)
+
+
+steppers = dict(
+    numpy=NumpyStepper,
+    native=NativeStepper,
+    threaded=ThreadedStepper
+)
+
+# -
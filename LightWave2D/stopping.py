@@ -0,0 +1,195 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+from typing import NoReturn, Dict
+import numpy
+from LightWave2D.physics import Physics
+from LightWave2D.grid import Grid
+from pydantic.dataclasses import dataclass
+
+config_dict = dict(
+    kw_only=True,
+    slots=True,
+    extra='forbid',
+    arbitrary_types_allowed=True
+)
+
+
+@dataclass(config=config_dict)
+class FieldDecay:
+    """
+    Stop criterion met once the electromagnetic energy in the grid has decayed below a fraction of its peak.
+
+    The energy ``0.5 * sum(epsilon * Ez**2 + mu_0 * (Hx**2 + Hy**2)) * dx * dy``
+    is evaluated every `check_every` time steps. It suits pulsed sources
+    (e.g. Impulsion) whose energy leaves through the PML long before n_steps.
+    Nothing is stopped before the fields have carried any energy, so a
+    delayed source does not end the run. The peak energy is part of the
+    checkpointed state (`get_state`).
+
+    Attributes:
+        threshold (float): Fraction of the peak energy below which the run stops (default is 1e-6).
+        check_every (int): Number of time steps between two evaluations (default is 50).
+        minimum_steps (int): Number of time steps always run (default is 0).
+    """
+    threshold: float = 1e-6
+    check_every: int = 50
+    minimum_steps: int = 0
+
+    def initialize(self, grid: Grid, epsilon: numpy.ndarray, detector_bank: 'DetectorBank', dtype: numpy.dtype = numpy.float64) -> NoReturn:
+        """
+        Reset the criterion before a simulation.
+
+        Args:
+            grid (Grid): The grid of the simulation mesh.
+            epsilon (numpy.ndarray): The permittivity mesh [F/m].
+            detector_bank (DetectorBank): The bank sampling the detectors of the run.
+            dtype (numpy.dtype): Floating point type of the fields.
+        """
+        assert self.check_every > 0, f"Invalid check_every: {self.check_every}, it must be positive."
+
+        self.sqrt_epsilon = numpy.sqrt(epsilon).astype(dtype)
+        self.scaled_Ez = numpy.empty(epsilon.shape, dtype=dtype)
+        self.area = grid.dx * grid.dy
+        self.peak_energy = numpy.zeros(())
+        self.energy = 0.0
+
+    def get_state(self) -> Dict[str, numpy.ndarray]:
+        """
+        The arrays carried by the criterion from one check to the next, updated in place, as saved by a Checkpoint.
+        """
+        return dict(peak_energy=self.peak_energy)
+
+    def get_energy(self, Ez: numpy.ndarray, Hx: numpy.ndarray, Hy: numpy.ndarray) -> float:
+        """
+        Total electromagnetic energy per unit length along z [J/m].
+        """
+        numpy.multiply(self.sqrt_epsilon, Ez, out=self.scaled_Ez)
+
+        electric = float(numpy.vdot(self.scaled_Ez, self.scaled_Ez))
+        magnetic = float(numpy.vdot(Hx, Hx) + numpy.vdot(Hy, Hy))
+
+        return 0.5 * (electric + Physics.mu_0 * magnetic) * self.area
+
+    def is_met(self, iteration: int, Ez: numpy.ndarray, Hx: numpy.ndarray, Hy: numpy.ndarray) -> bool:
+        """
+        Whether the run can stop after the given time step.
+
+        Args:
+            iteration (int): The time step index just completed.
+            Ez, Hx, Hy (numpy.ndarray): The fields after that time step.
+        """
+        if (iteration + 1) % self.check_every or iteration + 1 < self.minimum_steps:
+            return False
+
+        self.energy = self.get_energy(Ez, Hx, Hy)
+        self.peak_energy[...] = max(float(self.peak_energy), self.energy)
+
+        return self.peak_energy > 0 and self.energy <= self.threshold * self.peak_energy
+
+    def __str__(self) -> str:
+        return f"field energy decayed to {self.energy / self.peak_energy:.3e} of its peak"
+
+
+@dataclass(config=config_dict)
+class MonitorConvergence:
+    """
+    Stop criterion met once the frequency monitors stop changing.
+
+    The running transforms of all the FrequencyMonitor are compared every
+    `window` time steps. Let S be the transforms at the current check and I
+    the contribution of the last window. The criterion is met either when
+    ``|I| <= tolerance * |S|`` (the fields have decayed, the transforms are
+    final) or when ``|I - I_previous| <= tolerance * |I|`` (steady state,
+    every window adds the same contribution, i.e. the normalized spectrum
+    has converged). The second test is exact when the window spans a whole
+    number of periods of every monitored wavelength and otherwise accurate
+    to about 1 / (4 pi n_periods), so the window should span many periods.
+    The sum and the increment of the previous check are part of the
+    checkpointed state (`get_state`).
+
+    Attributes:
+        tolerance (float): Relative change below which the monitors are converged (default is 1e-3).
+        window (int): Number of time steps between two comparisons (default is 500).
+        minimum_steps (int): Number of time steps always run (default is 0).
+    """
+    tolerance: float = 1e-3
+    window: int = 500
+    minimum_steps: int = 0
+
+    def initialize(self, grid: Grid, epsilon: numpy.ndarray, detector_bank: 'DetectorBank', dtype: numpy.dtype = numpy.float64) -> NoReturn:
+        """
+        Reset the criterion before a simulation.
+
+        Args:
+            grid (Grid): The grid of the simulation mesh.
+            epsilon (numpy.ndarray): The permittivity mesh [F/m].
+            detector_bank (DetectorBank): The bank sampling the detectors of the run.
+            dtype (numpy.dtype): Floating point type of the fields.
+        """
+        assert self.window > 0, f"Invalid window: {self.window}, it must be positive."
+
+        if not detector_bank.monitors:
+            raise ValueError("MonitorConvergence requires at least one frequency monitor in the experiment.")
+
+        self.monitors = detector_bank.monitors
+        self.previous_sum = numpy.zeros_like(self.get_sum())
+        self.previous_increment = numpy.zeros_like(self.previous_sum)
+        self.n_checks = numpy.zeros((), dtype=int)
+        self.change = numpy.inf
+
+    def get_state(self) -> Dict[str, numpy.ndarray]:
+        """
+        The arrays carried by the criterion from one check to the next, updated in place, as saved by a Checkpoint.
+        """
+        return dict(previous_sum=self.previous_sum, previous_increment=self.previous_increment, n_checks=self.n_checks)
+
+    def get_sum(self) -> numpy.ndarray:
+        return numpy.concatenate([(monitor.real + 1j * monitor.imag).ravel() for monitor in self.monitors])
+
+    def is_met(self, iteration: int, Ez: numpy.ndarray, Hx: numpy.ndarray, Hy: numpy.ndarray) -> bool:
+        """
+        Whether the run can stop after the given time step.
+
+        Args:
+            iteration (int): The time step index just completed.
+            Ez, Hx, Hy (numpy.ndarray): The fields after that time step.
+        """
+        if (iteration + 1) % self.window:
+            return False
+
+        current_sum = self.get_sum()
+        n_checks = int(self.n_checks)
+        self.n_checks[...] = n_checks + 1
+
+        increment = current_sum - self.previous_sum
+        self.previous_sum[:] = current_sum
+        if n_checks == 0:
+            return False
+
+        previous_increment = self.previous_increment.copy()
+        self.previous_increment[:] = increment
+
+        if iteration + 1 < self.minimum_steps:
+            return False
+
+        norm = numpy.linalg.norm(current_sum)
+        increment_norm = numpy.linalg.norm(increment)
+        if norm == 0:
+            return False
+
+        if increment_norm <= self.tolerance * norm:
+            self.change = increment_norm / norm
+            return True
+
+        if n_checks == 1:
+            return False
+
+        self.change = numpy.linalg.norm(increment - previous_increment) / increment_norm
+
+        return self.change <= self.tolerance
+
+    def __str__(self) -> str:
+        return f"frequency monitors converged to a relative change of {self.change:.3e}"
+
+# -
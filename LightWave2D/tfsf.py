@@ -0,0 +1,244 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+from typing import NoReturn, Optional, Tuple
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.physics import Physics
+from pydantic.dataclasses import dataclass
+from matplotlib.patches import Rectangle
+import matplotlib.pyplot as plt
+
+config_dict = dict(
+    kw_only=True,
+    slots=True,
+    extra='forbid',
+    arbitrary_types_allowed=True
+)
+
+
+@dataclass(config=config_dict)
+class PlaneWave:
+    """
+    Plane wave travelling along +x, injected through a total-field / scattered-field (TF/SF) rectangle.
+
+    Inside the rectangle the grid holds the total field, incident plus
+    scattered, and outside only the scattered field. The incident field is
+    computed alongside on a 1D auxiliary grid with the same cell size and
+    time step, terminated by a graded absorber, and is added to or removed
+    from the leapfrog on the four sides of the rectangle. Along x the 1D and
+    2D Yee schemes share the same numerical dispersion, so with nothing
+    inside the rectangle no field leaks out of it. Scatterers placed inside
+    radiate into the scattered-field region only, which lets the domain be
+    shrunk around them.
+
+    The rectangle must lie in vacuum, outside of the PML and of the
+    components, and at least one cell away from the grid edges.
+
+    The waveform is ``amplitude * sin(omega (t - delay))``, multiplied by
+    ``exp(-((t - delay) / duration)**2)`` when a duration is given. Without
+    a wavelength the envelope alone is used (Gaussian pulse).
+
+    Attributes:
+        point_0 (Tuple[float | str, float | str]): First corner of the total-field rectangle.
+        point_1 (Tuple[float | str, float | str]): Opposite corner of the total-field rectangle.
+        wavelength (float): Wavelength of the carrier, None for a carrier-less pulse.
+        duration (float): Width of the Gaussian envelope [s], None for a continuous wave.
+        delay (float): Time of the envelope peak and phase origin of the carrier [s] (default is 0).
+        amplitude (float): Amplitude of the incident Ez (default is 1.0).
+        absorber_width (int): Number of cells of the absorber terminating the 1D grid (default is 40).
+    """
+    grid: Grid
+    point_0: Tuple[float | str, float | str]
+    point_1: Tuple[float | str, float | str]
+    wavelength: Optional[float] = None
+    duration: Optional[float] = None
+    delay: float = 0
+    amplitude: float = 1.0
+    absorber_width: int = 40
+    facecolor: str = 'none'
+    edgecolor: str = 'red'
+    alpha: float = 0.8
+
+    def __post_init__(self):
+        if self.wavelength is None and self.duration is None:
+            raise ValueError("A plane wave needs a wavelength, a duration or both.")
+
+        self.p0 = self.grid.get_coordinate(x=self.point_0[0], y=self.point_0[1])
+        self.p1 = self.grid.get_coordinate(x=self.point_1[0], y=self.point_1[1])
+
+        self.x_start, self.x_stop = sorted([self.p0.x_index, self.p1.x_index])
+        self.y_start, self.y_stop = sorted([self.p0.y_index, self.p1.y_index])
+
+        if self.x_start < 1 or self.y_start < 1 or self.x_stop > self.grid.n_x - 2 or self.y_stop > self.grid.n_y - 2:
+            raise ValueError("The total-field rectangle must be at least one cell away from the grid edges.")
+
+    def get_waveform(self, time: numpy.ndarray) -> numpy.ndarray:
+        """
+        Incident Ez written at the start of the 1D grid.
+
+        Args:
+            time (numpy.ndarray): The simulation times.
+
+        Returns:
+            numpy.ndarray: The values, same shape as `time`.
+        """
+        time = numpy.asarray(time) - self.delay
+        waveform = numpy.full(time.shape, float(self.amplitude))
+
+        if self.wavelength is not None:
+            waveform *= numpy.sin(2 * numpy.pi * Physics.c / self.wavelength * time)
+
+        if self.duration is not None:
+            waveform *= numpy.exp(-(time / self.duration) ** 2)
+
+        return waveform
+
+    def get_auxiliary_coefficients(self, n: int, absorber_start: int) -> Tuple[numpy.ndarray, ...]:
+        """
+        Update coefficients of the 1D grid, lossless up to `absorber_start` and graded with matched electric and magnetic losses after it.
+
+        Args:
+            n (int): Number of Ez nodes of the 1D grid.
+            absorber_start (int): First node of the absorber.
+
+        Returns:
+            tuple: ca and cb for the Ez nodes, da and db for the Hy nodes.
+        """
+        dt, dx = self.grid.dt, self.grid.dx
+
+        eta_0 = numpy.sqrt(Physics.mu_0 / Physics.epsilon_0)
+        sigma_max = 0.8 * 4 / (eta_0 * dx)
+
+        def get_loss(position: numpy.ndarray) -> numpy.ndarray:
+            depth = numpy.clip((position - absorber_start) / self.absorber_width, 0, 1)
+            return sigma_max * depth ** 3 * dt / (2 * Physics.epsilon_0)
+
+        electric_loss = get_loss(numpy.arange(n))
+        magnetic_loss = get_loss(numpy.arange(n - 1) + 0.5)
+
+        ca = (1 - electric_loss) / (1 + electric_loss)
+        cb = dt / Physics.epsilon_0 / dx / (1 + electric_loss)
+        da = (1 - magnetic_loss) / (1 + magnetic_loss)
+        db = dt / Physics.mu_0 / dx / (1 + magnetic_loss)
+
+        return ca, cb, da, db
+
+    def initialize(self, Ez: numpy.ndarray, Hx: numpy.ndarray, Hy: numpy.ndarray, coefficients: 'UpdateCoefficients') -> NoReturn:
+        """
+        Bind the TF/SF boundary to the fields and reset the 1D grid before a simulation.
+
+        Args:
+            Ez, Hx, Hy (numpy.ndarray): The simulation fields.
+            coefficients (UpdateCoefficients): The update coefficients of the fields.
+
+        Raises:
+            ValueError: If the boundary crosses a component or a damped (PML) cell.
+        """
+        x0, x1, y0, y1 = self.x_start, self.x_stop, self.y_start, self.y_stop
+        columns, rows = slice(y0, y1 + 1), slice(x0, x1 + 1)
+
+        # Cells on both sides of the boundary must be undamped vacuum.
+        region = slice(x0 - 1, x1 + 2), slice(y0 - 1, y1 + 2)
+        ring = numpy.ones((x1 - x0 + 3, y1 - y0 + 3), dtype=bool)
+        ring[2:-2, 2:-2] = False
+
+        vacuum = self.grid.dt / Physics.epsilon_0 / self.grid.dx
+        if numpy.any(coefficients.Ca[region][ring] != 1) or not numpy.allclose(coefficients.Cb_x[region][ring], vacuum, rtol=1e-6):
+            raise ValueError("The total-field rectangle of the plane wave must lie in vacuum, outside of the PML and of the components.")
+
+        # Node k of the 1D grid is row x0 - 2 + k, the source is written at k = 0.
+        self.last = x1 - x0 + 2
+        n = self.last + 2 + self.absorber_width
+        ca, cb, da, db = self.get_auxiliary_coefficients(n=n, absorber_start=self.last + 2)
+
+        self.ca, self.cb = ca[1:-1], cb[1:-1]
+        self.da, self.db = da, db
+        self.Ez_incident = numpy.zeros(n)
+        self.Hy_incident = numpy.zeros(n - 1)
+        self.electric_scratch = numpy.empty(n - 2)
+        self.magnetic_scratch = numpy.empty(n - 1)
+
+        self.waveform = self.get_waveform(self.grid.time_stamp)
+
+        self.Hy_low, self.Hy_high = Hy[x0 - 1, columns], Hy[x1, columns]
+        self.Hx_low, self.Hx_high = Hx[rows, y0 - 1], Hx[rows, y1]
+        self.Ez_low, self.Ez_high = Ez[x0, columns], Ez[x1, columns]
+
+        self.Db_y_low, self.Db_y_high = coefficients.Db_y[x0 - 1, columns], coefficients.Db_y[x1, columns]
+        self.Db_x_low, self.Db_x_high = coefficients.Db_x[rows, y0 - 1], coefficients.Db_x[rows, y1]
+        self.Cb_x_low, self.Cb_x_high = coefficients.Cb_x[x0, columns], coefficients.Cb_x[x1, columns]
+
+        self.row_scratch = numpy.empty(y1 - y0 + 1, dtype=Ez.dtype)
+        self.column_scratch = numpy.empty(x1 - x0 + 1, dtype=Ez.dtype)
+
+    def update_magnetic(self) -> NoReturn:
+        """
+        Correct the H components straddling the boundary with the incident Ez, then advance the incident Hy.
+        """
+        Ez_incident, scratch = self.Ez_incident, self.row_scratch
+
+        numpy.multiply(self.Db_y_low, Ez_incident[2], out=scratch)
+        numpy.subtract(self.Hy_low, scratch, out=self.Hy_low)
+
+        numpy.multiply(self.Db_y_high, Ez_incident[self.last], out=scratch)
+        numpy.add(self.Hy_high, scratch, out=self.Hy_high)
+
+        inside, scratch = Ez_incident[2:self.last + 1], self.column_scratch
+
+        numpy.multiply(self.Db_x_low, inside, out=scratch)
+        numpy.add(self.Hx_low, scratch, out=self.Hx_low)
+
+        numpy.multiply(self.Db_x_high, inside, out=scratch)
+        numpy.subtract(self.Hx_high, scratch, out=self.Hx_high)
+
+        numpy.subtract(Ez_incident[1:], Ez_incident[:-1], out=self.magnetic_scratch)
+        numpy.multiply(self.magnetic_scratch, self.db, out=self.magnetic_scratch)
+        numpy.multiply(self.Hy_incident, self.da, out=self.Hy_incident)
+        numpy.add(self.Hy_incident, self.magnetic_scratch, out=self.Hy_incident)
+
+    def update_electric(self, iteration: int) -> NoReturn:
+        """
+        Correct Ez along the boundary with the incident Hy, then advance the incident Ez and write the source.
+
+        Args:
+            iteration (int): The current time step index.
+        """
+        Hy_incident, scratch = self.Hy_incident, self.row_scratch
+
+        numpy.multiply(self.Cb_x_low, Hy_incident[1], out=scratch)
+        numpy.subtract(self.Ez_low, scratch, out=self.Ez_low)
+
+        numpy.multiply(self.Cb_x_high, Hy_incident[self.last], out=scratch)
+        numpy.add(self.Ez_high, scratch, out=self.Ez_high)
+
+        Ez_inner = self.Ez_incident[1:-1]
+        numpy.subtract(Hy_incident[1:], Hy_incident[:-1], out=self.electric_scratch)
+        numpy.multiply(self.electric_scratch, self.cb, out=self.electric_scratch)
+        numpy.multiply(Ez_inner, self.ca, out=Ez_inner)
+        numpy.add(Ez_inner, self.electric_scratch, out=Ez_inner)
+
+        self.Ez_incident[0] = self.waveform[iteration]
+
+    def add_to_ax(self, ax: plt.axis) -> NoReturn:
+        """
+        Add the total-field rectangle to the provided axis.
+
+        Args:
+            ax (Axis): The axis to which the rectangle will be added.
+        """
+        x, y = self.grid.x_stamp, self.grid.y_stamp
+
+        rectangle = Rectangle(
+            (x[self.x_start], y[self.y_start]),
+            x[self.x_stop] - x[self.x_start],
+            y[self.y_stop] - y[self.y_start],
+            facecolor=self.facecolor,
+            edgecolor=self.edgecolor,
+            alpha=self.alpha,
+            linestyle='--',
+            label='plane wave (TF/SF)'
+        )
+        ax.add_patch(rectangle)
+
+# -
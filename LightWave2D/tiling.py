@@ -0,0 +1,106 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+from typing import Tuple, List
+import numpy
+from LightWave2D.stepper import UpdateCoefficients
+
+
+class TiledEngine:
+    """
+    Cache-blocked stepping of the leapfrog with overlapped temporal tiling.
+
+    The compiled ``advance_tiled`` kernel cuts the grid into tiles of
+    `tile_shape` cells, each advanced several time steps in a private buffer
+    carrying a halo as deep as the number of steps, so the fields and
+    coefficients are streamed from memory once per block of steps instead of
+    once per step. The redundant halo work keeps the tiles independent and
+    the result bitwise identical to the plain leapfrog.
+
+    Sources are injected inside the kernel from the precomputed waveforms of
+    a :class:`SourceTable` and the detector cells are read back
+    after every step, the detector bank is fed from them afterwards. The CPML
+    and the non-linear components act between the half steps and are not
+    supported.
+
+    Args:
+        coefficients (UpdateCoefficients): The precomputed per-cell update coefficients.
+        tile_shape (tuple): Number of cells (along x, along y) owned by a tile.
+        steps_per_block (int): Maximum number of time steps advanced per tile pass.
+    """
+
+    def __init__(self, coefficients: UpdateCoefficients, tile_shape: Tuple[int, int] = (64, 64), steps_per_block: int = 8):
+        try:
+            from LightWave2D.binary import interface_yee
+        except ImportError as error:
+            raise ImportError(
+                "The tiled engine is not available, LightWave2D was installed without its compiled extension. "
+                "Reinstall with a C++ compiler and pybind11 available or use backend='numpy'."
+            ) from error
+
+        assert steps_per_block > 0, f"Invalid steps_per_block: {steps_per_block}, it must be positive."
+
+        self.interface = interface_yee
+        self.coefficients = coefficients
+        self.tile_shape = tuple(tile_shape)
+        self.steps_per_block = steps_per_block
+
+        self.fields = [numpy.zeros(coefficients.shape, dtype=coefficients.dtype) for _ in range(3)]
+        self.next_fields = [numpy.zeros(coefficients.shape, dtype=coefficients.dtype) for _ in range(3)]
+
+    @property
+    def Ez(self) -> numpy.ndarray:
+        return self.fields[0]
+
+    def get_blocks(self, n_steps: int, stops: numpy.ndarray) -> List[Tuple[int, int]]:
+        """
+        Cut the time steps into blocks of at most `steps_per_block` steps, ending a block at every requested stop.
+
+        Args:
+            n_steps (int): Total number of time steps.
+            stops (numpy.ndarray): Iterations after which the fields must be available (e.g. recorded frames).
+
+        Returns:
+            list: (start, stop) iteration ranges of the blocks.
+        """
+        cuts = set(range(0, n_steps, self.steps_per_block)) | set((numpy.asarray(stops, dtype=int) + 1).tolist()) | {n_steps}
+        cuts = sorted(cut for cut in cuts if 0 <= cut <= n_steps)
+
+        return list(zip(cuts[:-1], cuts[1:]))
+
+    def advance(self, n_steps: int, source_index: numpy.ndarray, source_values: numpy.ndarray, probe_index: numpy.ndarray) -> numpy.ndarray:
+        """
+        Advance the fields by one block of time steps.
+
+        Args:
+            n_steps (int): Number of time steps of the block.
+            source_index (numpy.ndarray): Flat grid indices written by the sources.
+            source_values (numpy.ndarray): Values written at those cells, shape (n_steps, n_source).
+            probe_index (numpy.ndarray): Flat grid indices read after every step.
+
+        Returns:
+            numpy.ndarray: Ez at the probes after every step, shape (n_steps, n_probe).
+        """
+        c = self.coefficients
+        Ez, Hx, Hy = self.fields
+        Ez_out, Hx_out, Hy_out = self.next_fields
+
+        probes = self.interface.advance_tiled(
+            Ez=Ez, Hx=Hx, Hy=Hy,
+            Ez_out=Ez_out, Hx_out=Hx_out, Hy_out=Hy_out,
+            Db_x=c.Db_x, Db_y=c.Db_y, Cb_x=c.Cb_x, Cb_y=c.Cb_y,
+            Ca=c.Ca if c.has_damping else None,
+            n_steps=n_steps,
+            tile_x=self.tile_shape[0],
+            tile_y=self.tile_shape[1],
+            source_index=source_index,
+            source_values=source_values,
+            probe_index=probe_index
+        )
+
+        self.fields, self.next_fields = self.next_fields, self.fields
+
+        return probes
+
+
+# -
@@ -0,0 +1,75 @@
+"""
+Benchmark: temporary allocations per time step
+==============================================
+
+Measures, with tracemalloc, the peak memory allocated on top of the live
+fields while advancing one TMz leapfrog step. The reference update below is
+the slicing expression the engine used before the scratch buffers were
+introduced; the second one is the buffered NumpyStepper. The number of
+full-grid temporaries is the peak divided by the size of one field.
+"""
+
+import time
+import tracemalloc
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.stepper import NumpyStepper
+
+
+def allocating_step(coefficients, Ez, Hx, Hy):
+    c = coefficients
+    Hx[:, :-1] -= c.Db_x[:, :-1] * (Ez[:, 1:] - Ez[:, :-1])
+    Hy[:-1, :] += c.Db_y[:-1, :] * (Ez[1:, :] - Ez[:-1, :])
+    Ez[1:-1, 1:-1] += c.Cb_x[1:-1, 1:-1] * (Hy[1:-1, 1:-1] - Hy[:-2, 1:-1]) - c.Cb_y[1:-1, 1:-1] * (Hx[1:-1, 1:-1] - Hx[1:-1, :-2])
+    Ez *= c.Ca
+
+
+def buffered_step(stepper, Ez, Hx, Hy):
+    stepper.update_magnetic(Ez, Hx, Hy)
+    stepper.update_electric(Ez, Hx, Hy)
+    stepper.apply_damping(Ez)
+
+
+def measure(step, n_steps: int, field_bytes: int) -> tuple:
+    step()  # warm-up, first call may allocate lazily
+
+    peaks = []
+    start = time.perf_counter()
+    for _ in range(n_steps):
+        tracemalloc.reset_peak()
+        current, _ = tracemalloc.get_traced_memory()
+        step()
+        _, peak = tracemalloc.get_traced_memory()
+        peaks.append(peak - current)
+    elapsed = (time.perf_counter() - start) / n_steps
+
+    peak = max(peaks)
+    return peak, peak / field_bytes, elapsed
+
+
+grid = Grid(resolution=0.1e-6, size_x=60e-6, size_y=30e-6, n_steps=50)
+experiment = Experiment(grid=grid)
+experiment.add_pml(order=1, width=50, sigma_max=5000)
+coefficients = experiment.get_update_coefficients()
+stepper = NumpyStepper(coefficients=coefficients)
+
+Ez, Hx, Hy = (numpy.zeros(grid.shape) for _ in range(3))
+Ez[grid.n_x // 2, grid.n_y // 2] = 1
+field_bytes = Ez.nbytes
+
+tracemalloc.start()
+
+cases = dict(
+    allocating=lambda: allocating_step(coefficients, Ez, Hx, Hy),
+    buffered=lambda: buffered_step(stepper, Ez, Hx, Hy),
+)
+
+print(f"grid {grid.shape}, one field = {field_bytes / 1e6:.2f} MB")
+for name, step in cases.items():
+    peak, n_temporaries, elapsed = measure(step, n_steps=grid.n_steps, field_bytes=field_bytes)
+    print(f"{name:>11}: peak temporaries {peak / 1e6:8.3f} MB/step  ~{n_temporaries:5.2f} full-grid arrays/step  {elapsed * 1e3:7.3f} ms/step")
+
+tracemalloc.stop()
+
+# -
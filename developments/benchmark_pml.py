@@ -0,0 +1,57 @@
+"""
+Benchmark: PML setup time
+=========================
+
+Times the construction of the PML conductivity profile across grid sizes.
+The cell-by-cell loop used before the profiles became separable 1D ramps is
+timed as well on the grids where it finishes in reasonable time.
+"""
+
+import time
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.pml import PML
+
+
+def loop_profile(grid: Grid, width: int, sigma_max: float, order: int) -> tuple:
+    sigma_x = numpy.zeros(grid.shape)
+    sigma_y = numpy.zeros(grid.shape)
+
+    for i in range(grid.n_x):
+        for j in range(grid.n_y):
+            if i < width:
+                sigma_x[i, j] = sigma_max * ((width - i) / width) ** order
+            elif i >= grid.n_x - width:
+                sigma_x[i, j] = sigma_max * ((i - (grid.n_x - width - 1)) / width) ** order
+
+            if j < width:
+                sigma_y[i, j] = sigma_max * ((width - j) / width) ** order
+            elif j >= grid.n_y - width:
+                sigma_y[i, j] = sigma_max * ((j - (grid.n_y - width - 1)) / width) ** order
+
+    return sigma_x, sigma_y
+
+
+def best_of(function, repeat: int = 3) -> float:
+    timings = []
+    for _ in range(repeat):
+        start = time.perf_counter()
+        function()
+        timings.append(time.perf_counter() - start)
+    return min(timings)
+
+
+print(f"{'grid':>12} {'vectorized [ms]':>16} {'loop [ms]':>12}")
+for n in [250, 500, 1000, 2000, 4000]:
+    grid = Grid(resolution=1e-8, size_x=n * 1e-8, size_y=n * 1e-8, n_steps=1)
+
+    vectorized = best_of(lambda: PML(grid=grid, width=50, sigma_max=5000, order=3))
+
+    if n <= 1000:
+        loop = f"{best_of(lambda: loop_profile(grid, width=50, sigma_max=5000, order=3), repeat=1) * 1e3:12.1f}"
+    else:
+        loop = f"{'skipped':>12}"
+
+    print(f"{str(grid.shape):>12} {vectorized * 1e3:16.3f} {loop}")
+
+# -
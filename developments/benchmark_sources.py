@@ -0,0 +1,44 @@
+"""
+Benchmark: source injection of a phased array
+=============================================
+
+Times the injection of an increasing number of point sources per time step,
+once with the former per-source ``add_source_to_field`` calls and once with
+the merged SourceTable used by run_fdtd. The table cost stays flat with the
+number of emitters.
+"""
+
+import time
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+
+grid = Grid(resolution=0.1e-6, size_x=60e-6, size_y=60e-6, n_steps=200)
+
+
+def build_array(n_emitters: int) -> Experiment:
+    experiment = Experiment(grid=grid)
+    for y in numpy.linspace(5, 95, n_emitters):
+        experiment.add_point_source(position=('20%', f'{y}%'), wavelength=[1310e-9, 1550e-9], amplitude=1)
+    return experiment
+
+
+for n_emitters in [1, 10, 100, 400]:
+    experiment = build_array(n_emitters)
+    Ez = numpy.zeros(grid.shape)
+
+    start = time.perf_counter()
+    for t in grid.time_stamp:
+        for source in experiment.sources:
+            source.add_source_to_field(Ez, time=t)
+    per_source = (time.perf_counter() - start) / grid.n_steps
+
+    table = experiment.get_source_table()
+    start = time.perf_counter()
+    for iteration in range(grid.n_steps):
+        table.inject(Ez, iteration)
+    merged = (time.perf_counter() - start) / grid.n_steps
+
+    print(f"{n_emitters:>4} emitters: per source {per_source * 1e6:9.1f} us/step   table {merged * 1e6:7.1f} us/step")
+
+# -
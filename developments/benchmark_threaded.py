@@ -0,0 +1,47 @@
+"""
+Benchmark: slab decomposition over worker threads
+=================================================
+
+Times one leapfrog step of the 'threaded' backend for an increasing number
+of worker threads on a large grid and reports the speed-up over a single
+worker. The grid size can be raised to 4000 x 4000 and beyond on machines
+with enough memory, the interesting regime being the one where a slab no
+longer fits in the cache of its core.
+"""
+
+import time
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.decomposition import ThreadedStepper, get_available_cores
+
+grid = Grid(resolution=0.1e-6, size_x=200e-6, size_y=200e-6, n_steps=20)
+experiment = Experiment(grid=grid)
+experiment.add_pml(order=1, width=50, sigma_max=5000)
+coefficients = experiment.get_update_coefficients()
+
+Ez, Hx, Hy = (numpy.zeros(grid.shape) for _ in range(3))
+Ez[grid.n_x // 2, grid.n_y // 2] = 1
+
+
+def measure(stepper, n_steps: int) -> float:
+    start = time.perf_counter()
+    for _ in range(n_steps):
+        stepper.update_magnetic(Ez, Hx, Hy)
+        stepper.update_electric(Ez, Hx, Hy)
+        stepper.apply_damping(Ez)
+    return (time.perf_counter() - start) / n_steps
+
+
+print(f"grid {grid.shape}, {get_available_cores()} cores available")
+
+reference = None
+n_workers = 1
+while n_workers <= get_available_cores():
+    with ThreadedStepper(coefficients=coefficients, n_workers=n_workers) as stepper:
+        elapsed = measure(stepper, n_steps=grid.n_steps)
+    reference = reference or elapsed
+    print(f"{n_workers:>3} workers: {elapsed * 1e3:8.2f} ms/step  speed-up {reference / elapsed:5.2f}")
+    n_workers *= 2
+
+# -
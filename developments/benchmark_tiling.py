@@ -0,0 +1,92 @@
+"""
+Benchmark: temporal tiling and memory traffic
+=============================================
+
+Compares the plain native leapfrog with the overlapped temporal tiling of
+TiledEngine on a grid much larger than the caches.
+
+The traffic is reported as compulsory DRAM bytes per cell-update from the
+access pattern of each scheme, not from hardware counters:
+
+    - plain: every step streams Ez, Hx, Hy in and out and the five
+      coefficients in, i.e. 11 doubles = 88 bytes per cell-update.
+    - tiled: a block of T steps streams the fields in and out and the
+      coefficients in once, plus the redundant halo of each tile, i.e.
+      88 * (halo area / tile area) / T bytes per cell-update.
+
+The achieved figure is measured: a streaming copy of arrays larger than the
+caches gives the sustainable DRAM bandwidth, and dividing it by the measured
+cell-update rate gives the bytes per cell-update the machine can afford at
+that rate. A scheme whose modelled traffic stays below that budget is
+compute bound; above it, the run is limited by memory and its actual rate
+is the bandwidth divided by the modelled traffic. A tiled run is effective
+when its rate exceeds what the plain scheme can reach at that bandwidth.
+"""
+
+import time
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.stepper import NativeStepper
+from LightWave2D.tiling import TiledEngine
+
+BYTES_PER_UPDATE = 11 * 8
+
+grid = Grid(resolution=0.1e-6, size_x=300e-6, size_y=300e-6, n_steps=32)
+experiment = Experiment(grid=grid)
+experiment.add_pml(order=1, width=50, sigma_max=5000)
+coefficients = experiment.get_update_coefficients()
+n_cells = grid.n_x * grid.n_y
+
+
+def get_stream_bandwidth(n_repeat: int = 5) -> float:
+    source, target = numpy.ones(n_cells), numpy.empty(n_cells)
+    best = numpy.inf
+    for _ in range(n_repeat):
+        start = time.perf_counter()
+        numpy.copyto(target, source)
+        best = min(best, time.perf_counter() - start)
+
+    # A copy reads the source and writes the target, the write allocation is not counted.
+    return 2 * source.nbytes / best
+
+
+def report(name: str, elapsed: float, bytes_per_update: float) -> None:
+    rate = n_cells * grid.n_steps / elapsed
+    budget = bandwidth / rate
+    print(
+        f"{name:>24}: {rate / 1e6:8.1f} Mcell-updates/s  "
+        f"modelled {bytes_per_update:6.1f} B/cell-update  achieved budget {budget:6.1f} B/cell-update  "
+        f"{min(rate * bytes_per_update, bandwidth) / 1e9:7.2f} GB/s"
+    )
+
+
+bandwidth = get_stream_bandwidth()
+print(f"grid {grid.shape}, stream bandwidth {bandwidth / 1e9:.2f} GB/s")
+
+stepper = NativeStepper(coefficients=coefficients)
+Ez, Hx, Hy = (numpy.zeros(grid.shape) for _ in range(3))
+
+start = time.perf_counter()
+for _ in range(grid.n_steps):
+    stepper.update_magnetic(Ez, Hx, Hy)
+    stepper.update_electric(Ez, Hx, Hy)
+    stepper.apply_damping(Ez)
+report('plain', time.perf_counter() - start, BYTES_PER_UPDATE)
+
+no_source, no_probe = numpy.arange(0), numpy.arange(0)
+
+for tile in [32, 64, 128]:
+    for steps_per_block in [4, 8, 16]:
+        engine = TiledEngine(coefficients=coefficients, tile_shape=(tile, tile), steps_per_block=steps_per_block)
+
+        start = time.perf_counter()
+        for block_start, block_stop in engine.get_blocks(n_steps=grid.n_steps, stops=[]):
+            n_steps = block_stop - block_start
+            engine.advance(n_steps=n_steps, source_index=no_source, source_values=numpy.zeros((n_steps, 0)), probe_index=no_probe)
+        elapsed = time.perf_counter() - start
+
+        halo_ratio = (tile + 2 * steps_per_block + 1) ** 2 / tile ** 2
+        report(f'tile {tile} x {steps_per_block} steps', elapsed, BYTES_PER_UPDATE * halo_ratio / steps_per_block)
+
+# -
@@ -0,0 +1,48 @@
+"""
+Distributed run over MPI
+========================
+
+Runs the same experiment serially and over the MPI ranks, then checks on
+rank 0 that the detectors agree. Launch it on the local machine with
+
+    python -m LightWave2D.distributed -n 4 developments/distributed_example.py
+
+or directly with ``mpirun -n 4 python developments/distributed_example.py``.
+"""
+
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.distributed import DistributedExperiment, get_communicator
+
+
+def build_experiment():
+    grid = Grid(resolution=0.1e-6, size_x=40e-6, size_y=30e-6, n_steps=400)
+    experiment = Experiment(grid=grid)
+
+    experiment.add_circle(position=('60%', '50%'), epsilon_r=2, radius=3e-6)
+    experiment.add_point_source(wavelength=1550e-9, position=('25%', '50%'), amplitude=10)
+    experiment.add_point_detector(position=('80%', '50%'))
+    experiment.add_frequency_monitor(wavelength=1550e-9, point_0=('75%', '10%'), point_1=('75%', '90%'))
+    experiment.add_cpml(width=20)
+
+    return experiment
+
+
+comm = get_communicator()
+
+distributed = build_experiment()
+DistributedExperiment(experiment=distributed, comm=comm).run_fdtd()
+
+if comm.Get_rank() == 0:
+    reference = build_experiment()
+    reference.run_fdtd(recording='none')
+
+    identical = [numpy.array_equal(serial.data, parallel.data) for serial, parallel in zip(reference.detectors, distributed.detectors)]
+    for detector, is_identical in zip(reference.detectors, identical):
+        print(type(detector).__name__, 'identical:', is_identical)
+
+    if not all(identical):
+        raise SystemExit("The distributed detectors differ from the serial ones.")
+
+# -
@@ -0,0 +1,44 @@
+"""
+Frequency domain sweep of a lens
+================================
+
+Solves the steady state of a CW line source focused by a lens with the FDFD
+solver, then sweeps the source position: the operator is factorized once
+and every new position only costs a triangular solve. The time of the
+equivalent time domain run is printed for comparison.
+"""
+
+import time
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.frequency_domain import FrequencyDomainExperiment
+
+grid = Grid(resolution=0.1e-6, size_x=40e-6, size_y=30e-6, n_steps=2000)
+experiment = Experiment(grid=grid, subpixel_smoothing=True)
+experiment.add_lense(position=('35%', '50%'), epsilon_r=2, curvature=10e-6, width=5e-6)
+experiment.add_line_source(wavelength=1550e-9, point_0=('10%', '20%'), point_1=('10%', '80%'), amplitude=1, mode='soft')
+experiment.add_cpml(width=20)
+
+start = time.perf_counter()
+solver = FrequencyDomainExperiment(experiment=experiment, wavelength=1550e-9)
+solver.solve()
+print(f"FDFD assembly, factorization and first solve: {time.perf_counter() - start:.2f} s")
+
+currents = []
+for y_index in numpy.linspace(0.3 * grid.n_y, 0.7 * grid.n_y, 20).astype(int):
+    current = numpy.zeros(grid.shape, dtype=complex)
+    current[grid.n_x // 10, y_index] = 1
+    currents.append(current)
+
+start = time.perf_counter()
+fields = solver.solve(numpy.stack(currents))
+print(f"{len(currents)} further source positions: {time.perf_counter() - start:.2f} s")
+
+start = time.perf_counter()
+experiment.run_fdtd(recording='none')
+print(f"time domain run of {grid.n_steps} steps: {time.perf_counter() - start:.2f} s")
+
+solver.plot_field()
+
+# -
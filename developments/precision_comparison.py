@@ -0,0 +1,85 @@
+"""
+Accuracy and cost of the float32 mode
+=====================================
+
+Runs the lens and ring resonator setups of the example gallery in float64,
+in float32 and in float32 with the frequency monitor accumulated in float64,
+and reports, against the float64 run:
+
+    - the relative L2 error of the last Ez frame,
+    - the largest deviation of the detector trace relative to its peak,
+    - the relative L2 error of the monitored 1550 nm field,
+    - the memory of the fields and coefficients and the time per step.
+
+The results are printed as the rows of the table of the "Numerical precision"
+section of docs/source/theory.rst.
+"""
+
+import time
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.recording import Recording
+
+
+def build_lense(precision: str, monitor_precision: str) -> Experiment:
+    grid = Grid(resolution=0.1e-6, size_x=60e-6, size_y=30e-6, n_steps=1200)
+    experiment = Experiment(grid=grid, precision=precision, monitor_precision=monitor_precision)
+    experiment.add_lense(position=('35%', '50%'), epsilon_r=2, curvature=10e-6, width=5e-6)
+    experiment.add_point_source(wavelength=1550e-9, position=('10%', '50%'), amplitude=10)
+    experiment.add_pml(order=1, width=50, sigma_max=5000)
+    return experiment
+
+
+def build_resonator(precision: str, monitor_precision: str) -> Experiment:
+    grid = Grid(resolution=0.1e-6, size_x=50e-6, size_y=30e-6, n_steps=800)
+    experiment = Experiment(grid=grid, precision=precision, monitor_precision=monitor_precision)
+    experiment.add_ring_resonator(position=('35%', '50%'), epsilon_r=1.5, inner_radius=4e-6, width=2e-6)
+    experiment.add_point_source(wavelength=1550e-9, position=('25%', '50%'), amplitude=100)
+    experiment.add_pml(order=1, width=70, sigma_max=5000)
+    return experiment
+
+
+def run(build, precision: str, monitor_precision: str = None) -> tuple:
+    experiment = build(precision, monitor_precision)
+    experiment.add_point_detector(position=('70%', '50%'))
+    experiment.add_frequency_monitor(wavelength=1550e-9, point_0=('60%', '10%'), point_1=('60%', '90%'))
+
+    start = time.perf_counter()
+    experiment.run_fdtd(recording=Recording(every=None, frames=[-1]))
+    elapsed = (time.perf_counter() - start) / experiment.grid.n_steps
+
+    coefficients = experiment.get_update_coefficients()
+    memory = 3 * experiment.grid.n_x * experiment.grid.n_y * experiment.dtype.itemsize
+    memory += sum(getattr(coefficients, name).nbytes for name in ['Db_x', 'Db_y', 'Cb_x', 'Cb_y', 'Ca'])
+
+    return experiment, elapsed, memory
+
+
+def relative_error(value: numpy.ndarray, reference: numpy.ndarray) -> float:
+    return numpy.linalg.norm(value - reference) / numpy.linalg.norm(reference)
+
+
+for name, build in [('lense', build_lense), ('resonator', build_resonator)]:
+    reference, reference_time, reference_memory = run(build, 'float64')
+    reference_trace = reference.detectors[0].data
+
+    print(f"   * - {name}, float64")
+    print("     - ")
+    print("     - ")
+    print("     - ")
+    print(f"     - {reference_memory / 1e6:.1f} MB")
+    print(f"     - {reference_time * 1e3:.2f} ms")
+
+    for label, monitor_precision in [('float32', None), ('float32, float64 monitor', 'float64')]:
+        single, single_time, single_memory = run(build, 'float32', monitor_precision)
+        trace = single.detectors[0].data
+
+        print(f"   * - {name}, {label}")
+        print(f"     - {relative_error(single.Ez_t[-1], reference.Ez_t[-1]):.1e}")
+        print(f"     - {numpy.abs(trace - reference_trace).max() / numpy.abs(reference_trace).max():.1e}")
+        print(f"     - {relative_error(single.detectors[1].data, reference.detectors[1].data):.1e}")
+        print(f"     - {single_memory / 1e6:.1f} MB")
+        print(f"     - {single_time * 1e3:.2f} ms")
+
+# -
@@ -0,0 +1,39 @@
+"""
+Eigenmodes of a dielectric disk
+===============================
+
+Finds the whispering gallery modes of a disk around 1550 nm with the
+shift-invert eigenmode solver, then checks the wavelength and Q of the
+first one with a short time domain run analysed by harmonic inversion.
+"""
+
+import time
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.eigenmode import EigenmodeSolver
+
+grid = Grid(resolution=0.05e-6, size_x=10e-6, size_y=10e-6, n_steps=4000)
+experiment = Experiment(grid=grid, subpixel_smoothing=True)
+experiment.add_circle(position=('50%', '50%'), radius=2.5e-6, epsilon_r=6)
+experiment.add_cpml(width=20)
+
+start = time.perf_counter()
+solver = EigenmodeSolver(experiment=experiment, wavelength=1550e-9, n_modes=6)
+solver.solve()
+print(f"eigenmodes: {time.perf_counter() - start:.2f} s")
+
+for wavelength, quality_factor in zip(solver.mode_wavelength, solver.quality_factor):
+    print(f"wavelength: {wavelength:.6e} m, Q: {quality_factor:.4e}")
+
+experiment.add_impulsion(position=(7.3e-6, 5e-6), duration=3e-15, delay=12e-15)
+detector = experiment.add_point_detector(position=(7.2e-6, 5.3e-6))
+
+start = time.perf_counter()
+experiment.run_fdtd(recording='none')
+resonances = detector.get_resonances(start_time=40e-15, stride=4, wavelength_range=(1450e-9, 1650e-9))
+print(f"time domain run and harmonic inversion: {time.perf_counter() - start:.2f} s")
+print(resonances)
+
+solver.plot_mode(0)
+
+# -
@@ -0,0 +1,56 @@
+"""
+Broadband transmission of a ring of scatterers
+==============================================
+
+Computes the transmission and reflection spectra of a ring of dielectric
+cylinders over 41 wavelengths from one pulsed run, against one PointSource
+run per wavelength. The reference run is made once and reused by the
+second device.
+"""
+
+import time
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.spectrum import TransmissionSpectrum
+
+wavelength = numpy.linspace(1300e-9, 1700e-9, 41)
+
+
+def build_experiment(radius: float) -> Experiment:
+    grid = Grid(resolution=0.05e-6, size_x=20e-6, size_y=12e-6, n_steps=3000)
+    experiment = Experiment(grid=grid)
+
+    for angle in numpy.linspace(0, 2 * numpy.pi, 12, endpoint=False):
+        experiment.add_circle(position=(10e-6 + 2e-6 * numpy.cos(angle), 6e-6 + 2e-6 * numpy.sin(angle)), radius=radius, epsilon_r=4)
+
+    experiment.add_cpml(width=20)
+
+    return experiment
+
+
+spectrum = TransmissionSpectrum(
+    experiment=build_experiment(radius=0.4e-6),
+    wavelength=wavelength,
+    source_position=('15%', '50%'),
+    input_line=(('25%', '5%'), ('25%', '95%')),
+    output_line=(('80%', '5%'), ('80%', '95%'))
+)
+
+start = time.perf_counter()
+spectrum.run()
+print(f"reference and device runs: {time.perf_counter() - start:.2f} s")
+
+start = time.perf_counter()
+spectrum.run(build_experiment(radius=0.5e-6))
+print(f"second device, reference reused: {time.perf_counter() - start:.2f} s")
+
+experiment = build_experiment(radius=0.5e-6)
+experiment.add_point_source(wavelength=wavelength[0], position=('15%', '50%'))
+start = time.perf_counter()
+experiment.run_fdtd(recording='none')
+print(f"one PointSource run: {time.perf_counter() - start:.2f} s, {wavelength.size} needed for the sweep")
+
+spectrum.plot()
+
+# -
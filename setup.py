@@ -3,4 +3,24 @@
 
 from setuptools import setup
 
-setup()
+try:
+    from pybind11.setup_helpers import Pybind11Extension, build_ext
+except ImportError:  # The native backend is optional, the numpy engine works without it
+    ext_modules, cmdclass = [], {}
+else:
+    ext_modules = [
+        Pybind11Extension(
+            'LightWave2D.binary.interface_yee',
+            sources=['LightWave2D/cpp/interface.cpp'],
+            include_dirs=['LightWave2D/cpp'],
+            extra_compile_args=['-O3', '-fopenmp', '-ffp-contract=off'],
+            extra_link_args=['-fopenmp'],
+            optional=True,
+        )
+    ]
+    cmdclass = dict(build_ext=build_ext)
+
+setup(
+    ext_modules=ext_modules,
+    cmdclass=cmdclass
+)
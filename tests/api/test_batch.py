@@ -0,0 +1,47 @@
+import pytest
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.batch import BatchExperiment
+
+
+def build_experiment(grid, epsilon_r):
+    experiment = Experiment(grid=grid)
+
+    experiment.add_circle(position=('60%', '50%'), epsilon_r=epsilon_r, radius=1e-6)
+    experiment.add_point_source(wavelength=1550e-9, position=('25%', '50%'), amplitude=10)
+    experiment.add_point_detector(position=('80%', '50%'))
+    experiment.add_frequency_monitor(wavelength=[1310e-9, 1550e-9], point_0=('70%', '20%'), point_1=('70%', '80%'))
+    experiment.add_pml(order=1, width=10, sigma_max=5000)
+
+    return experiment
+
+
+# Test that stepping the variants together reproduces independent runs
+def test_batch_matches_sequential_runs():
+    grid = Grid(resolution=0.1e-6, size_x=8e-6, size_y=6e-6, n_steps=60)
+    epsilons = [1.5, 2, 3]
+
+    references = [build_experiment(grid, epsilon_r) for epsilon_r in epsilons]
+    for reference in references:
+        reference.run_fdtd()
+
+    batch = BatchExperiment(experiments=[build_experiment(grid, epsilon_r) for epsilon_r in epsilons])
+    batch.run_fdtd()
+
+    for reference, variant in zip(references, batch.experiments):
+        assert numpy.array_equal(reference.Ez_t, variant.Ez_t)
+        assert numpy.array_equal(reference.detectors[0].data, variant.detectors[0].data)
+        assert numpy.array_equal(reference.detectors[1].data, variant.detectors[1].data)
+        assert (variant.n_steps_run, variant.stop_reason) == (reference.n_steps_run, reference.stop_reason)
+
+
+def test_batch_requires_shared_grid():
+    experiments = [
+        build_experiment(Grid(resolution=0.1e-6, size_x=8e-6, size_y=6e-6, n_steps=60), 2) for _ in range(2)
+    ]
+
+    with pytest.raises(ValueError):
+        BatchExperiment(experiments=experiments)
+
+# -
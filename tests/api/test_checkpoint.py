@@ -0,0 +1,119 @@
+import os
+import pytest
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.checkpoint import Checkpoint
+from LightWave2D.stopping import FieldDecay, MonitorConvergence
+
+
+def build_experiment(n_steps=60, wavelength=1550e-9):
+    grid = Grid(resolution=0.1e-6, size_x=8e-6, size_y=6e-6, n_steps=n_steps)
+    experiment = Experiment(grid=grid)
+
+    experiment.add_circle(position=('60%', '50%'), epsilon_r=2, radius=1e-6)
+    experiment.add_point_source(wavelength=wavelength, position=('25%', '50%'), amplitude=10)
+    experiment.add_point_detector(position=('80%', '50%'))
+    experiment.add_frequency_monitor(wavelength=1550e-9, point_0=('70%', '20%'), point_1=('70%', '80%'))
+    experiment.add_cpml(width=8)
+
+    return experiment
+
+
+class Interrupted(Exception):
+    pass
+
+
+class Interruption:
+    """
+    Stop criterion killing the run before the given time step, as a job reaching its wall time would.
+    """
+    def __init__(self, step):
+        self.step = step
+
+    def initialize(self, **kwargs):
+        pass
+
+    def get_state(self):
+        return {}
+
+    def is_met(self, iteration, Ez, Hx, Hy):
+        if iteration + 1 == self.step:
+            raise Interrupted()
+
+        return False
+
+
+# Test that resuming from a checkpoint continues the run bitwise identically
+def test_resume_is_bitwise_identical(tmp_path):
+    reference = build_experiment()
+    reference.run_fdtd()
+
+    checkpoint = Checkpoint(path=str(tmp_path / 'run.npz'), every=25)
+
+    with pytest.raises(Interrupted):
+        build_experiment().run_fdtd(checkpoint=checkpoint, stop_criteria=Interruption(step=55))
+
+    with numpy.load(checkpoint.path) as data:
+        assert int(data['next_iteration']) == 50
+
+    resumed = build_experiment()
+    resumed.run_fdtd(checkpoint=checkpoint)
+
+    assert numpy.array_equal(reference.Ez_t, resumed.Ez_t)
+    for expected, detector in zip(reference.detectors, resumed.detectors):
+        assert numpy.array_equal(expected.data, detector.data)
+
+    assert not os.path.exists(checkpoint.path)
+
+
+# Test that a checkpoint of another run is refused, whether the grid or only the sources changed
+@pytest.mark.parametrize('other', [dict(n_steps=80), dict(wavelength=1310e-9)])
+def test_mismatching_checkpoint(tmp_path, other):
+    checkpoint = Checkpoint(path=str(tmp_path / 'run.npz'), every=10)
+
+    with pytest.raises(Interrupted):
+        build_experiment().run_fdtd(checkpoint=checkpoint, stop_criteria=Interruption(step=35))
+
+    with pytest.raises(ValueError):
+        build_experiment(**other).run_fdtd(checkpoint=checkpoint)
+
+
+def build_pulse_experiment():
+    grid = Grid(resolution=0.1e-6, size_x=8e-6, size_y=6e-6, n_steps=1000)
+    experiment = Experiment(grid=grid)
+
+    experiment.add_impulsion(duration=2e-15, delay=6e-15, position=('30%', '50%'), amplitude=10)
+    experiment.add_point_detector(position=('70%', '50%'))
+    experiment.add_frequency_monitor(wavelength=1550e-9, position=('70%', '50%'))
+    experiment.add_cpml(width=10)
+
+    return experiment
+
+
+# Test that a run resumed with stop criteria stops at the same step as an uninterrupted one
+def test_resume_with_stop_criteria(tmp_path):
+    def get_stop_criteria():
+        return [FieldDecay(threshold=1e-3, check_every=20), MonitorConvergence(tolerance=1e-3, window=50)]
+
+    reference = build_pulse_experiment()
+    reference.run_fdtd(recording='none', stop_criteria=get_stop_criteria())
+
+    checkpoint = Checkpoint(path=str(tmp_path / 'run.npz'), every=70)
+    interruption = Interruption(step=reference.n_steps_run - 10)
+    with pytest.raises(Interrupted):
+        build_pulse_experiment().run_fdtd(recording='none', checkpoint=checkpoint, stop_criteria=get_stop_criteria() + [interruption])
+
+    with numpy.load(checkpoint.path) as data:
+        assert 0 < int(data['next_iteration']) < reference.n_steps_run
+        assert float(data['stop_0_peak_energy']) > 0
+
+    resumed = build_pulse_experiment()
+    resumed.run_fdtd(recording='none', checkpoint=checkpoint, stop_criteria=get_stop_criteria())
+
+    assert resumed.n_steps_run == reference.n_steps_run < reference.grid.n_steps
+    assert resumed.stop_reason == reference.stop_reason
+    for expected, detector in zip(reference.detectors, resumed.detectors):
+        assert numpy.array_equal(expected.data, detector.data)
+
+# -
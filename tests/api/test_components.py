@@ -0,0 +1,121 @@
+import pytest
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.physics import Physics
+from LightWave2D.eigenmode import EigenmodeSolver
+
+
+def full_grid_mask(component):
+    x_mesh, y_mesh = numpy.meshgrid(component.grid.x_stamp, component.grid.y_stamp, indexing='ij')
+    points = numpy.c_[x_mesh.ravel(), y_mesh.ravel()]
+    return component.contains_points(points).reshape(component.grid.shape)
+
+
+# Test that the bounding-box patch matches a full-grid rasterization
+@pytest.mark.parametrize("method, params", [
+    ('add_square', {'position': ('25%', '20%'), 'epsilon_r': 2, 'side_length': 3e-6, 'rotation': 0.3}),
+    ('add_circle', {'position': ('50%', '50%'), 'epsilon_r': 2, 'radius': 2e-6}),
+    ('add_ellipse', {'position': ('25%', '70%'), 'epsilon_r': 2, 'width': 5e-6, 'height': 10e-6, 'rotation': 10}),
+    ('add_ring_resonator', {'position': ('60%', '50%'), 'epsilon_r': 2, 'inner_radius': 2e-6, 'width': 1e-6}),
+    ('add_lense', {'position': ('90%', '50%'), 'epsilon_r': 2, 'curvature': 10e-6, 'width': 5e-6}),
+])
+def test_patch_rasterization(method, params):
+    grid = Grid(resolution=0.1e-6, size_x=20e-6, size_y=15e-6, n_steps=10)
+    experiment = Experiment(grid=grid)
+    component = getattr(experiment, method)(**params)
+
+    assert component.mask.shape == component.idx[component.patch_slice].shape
+    assert numpy.array_equal(component.idx, full_grid_mask(component))
+
+    epsilon = experiment.get_epsilon() / Physics.epsilon_0
+    assert numpy.all(epsilon[component.idx] == 2)
+    assert numpy.all(epsilon[~component.idx] == 1)
+
+
+def test_ring_resonator_hole():
+    grid = Grid(resolution=0.1e-6, size_x=20e-6, size_y=20e-6, n_steps=10)
+    experiment = Experiment(grid=grid)
+    ring = experiment.add_ring_resonator(position=('50%', '50%'), epsilon_r=2, inner_radius=4e-6, width=1e-6)
+
+    center = grid.get_coordinate(x=ring.coordinate.x, y=ring.coordinate.y)
+    assert not ring.idx[center.x_index, center.y_index]
+    assert ring.idx.any()
+
+
+# Test that non-linearity is opt-in and restricted to the component's cells
+def test_non_linear_component():
+    grid = Grid(resolution=0.1e-6, size_x=10e-6, size_y=10e-6, n_steps=10)
+    experiment = Experiment(grid=grid)
+    linear = experiment.add_circle(position=('30%', '50%'), epsilon_r=2, radius=1e-6)
+    non_linear = experiment.add_circle(position=('70%', '50%'), epsilon_r=2, radius=1e-6, chi_2=1e10)
+
+    assert not linear.is_non_linear
+    assert non_linear.is_non_linear
+    assert non_linear.flat_index.size == non_linear.mask.sum()
+
+    field = numpy.ones(grid.shape)
+    linear.add_non_linear_effect_to_field(field)
+    assert numpy.all(field == 1)
+
+    non_linear.add_non_linear_effect_to_field(field)
+    factor = grid.dt**2 / (2 * Physics.epsilon_0 * Physics.mu_0) * 1e10
+    assert numpy.allclose(field[non_linear.idx], 1 + factor)
+    assert numpy.all(field[~non_linear.idx] == 1)
+
+
+# Test that the smoothed permittivity carries the area of the component and keeps the staircase away from its boundary
+@pytest.mark.parametrize("method, params, area", [
+    ('add_circle', {'position': ('50%', '50%'), 'epsilon_r': 3, 'radius': 1.23e-6}, numpy.pi * 1.23e-6**2),
+    ('add_square', {'position': ('50%', '50%'), 'epsilon_r': 3, 'side_length': 2.13e-6, 'rotation': 20}, 2.13e-6**2),
+    ('add_ring_resonator', {'position': ('50%', '50%'), 'epsilon_r': 3, 'inner_radius': 2e-6, 'width': 0.55e-6}, numpy.pi * (2.55e-6**2 - 2e-6**2)),
+])
+def test_subpixel_smoothing(method, params, area):
+    grid = Grid(resolution=0.1e-6, size_x=8e-6, size_y=8e-6, n_steps=10)
+
+    staircase = Experiment(grid=grid)
+    getattr(staircase, method)(**params)
+
+    smoothed = Experiment(grid=grid, subpixel_smoothing=True, subpixel_samples=16)
+    component = getattr(smoothed, method)(**params)
+
+    epsilon = smoothed.get_epsilon() / Physics.epsilon_0
+    reference = staircase.get_epsilon() / Physics.epsilon_0
+
+    assert numpy.all((epsilon >= 1) & (epsilon <= 3))
+
+    fraction = component.get_fill_fraction(n_samples=16)
+    interior = numpy.zeros(grid.shape, dtype=bool)
+    interior[component.patch_slice] = (fraction == 0) | (fraction == 1)
+    assert numpy.array_equal(epsilon[interior], reference[interior])
+
+    smoothed_area = (epsilon - 1).sum() / 2 * grid.dx * grid.dy
+    assert smoothed_area == pytest.approx(area, rel=5e-3)
+
+
+def get_disk_resonance(resolution, radius, subpixel_smoothing):
+    grid = Grid(resolution=resolution, size_x=4e-6, size_y=4e-6, n_steps=10)
+    experiment = Experiment(grid=grid, subpixel_smoothing=subpixel_smoothing)
+    experiment.add_circle(position=('50%', '50%'), epsilon_r=9, radius=radius)
+
+    solver = EigenmodeSolver(experiment=experiment, wavelength=50e-6, n_modes=1)
+    solver.solve()
+
+    return solver.mode_wavelength[0]
+
+
+# Test that on a coarse grid the smoothed disk resonates within 1e-3 of the fine grid reference, and closer to it than the staircased one
+def test_subpixel_smoothing_resonance():
+    staircase_error, smoothed_error = 0, 0
+    for radius in [1.13e-6, 1.23e-6, 1.37e-6]:
+        reference = get_disk_resonance(resolution=0.02e-6, radius=radius, subpixel_smoothing=True)
+
+        smoothed = get_disk_resonance(resolution=0.1e-6, radius=radius, subpixel_smoothing=True)
+        assert abs(smoothed - reference) / reference < 1e-3
+
+        staircase_error += abs(get_disk_resonance(resolution=0.1e-6, radius=radius, subpixel_smoothing=False) - reference)
+        smoothed_error += abs(smoothed - reference)
+
+    assert smoothed_error < staircase_error
+
+# -
@@ -0,0 +1,37 @@
+import pytest
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+
+
+def build_experiment():
+    grid = Grid(resolution=0.1e-6, size_x=8e-6, size_y=6e-6, n_steps=50)
+    experiment = Experiment(grid=grid)
+
+    experiment.add_point_source(wavelength=1550e-9, position=('25%', '50%'), amplitude=10)
+
+    return experiment
+
+
+# Test that the running DFT matches a transform of the stored history
+@pytest.mark.parametrize("geometry", [
+    {'position': ('70%', '50%')},
+    {'point_0': ('60%', '10%'), 'point_1': ('60%', '90%')},
+    {'region': (('50%', '20%'), ('80%', '60%'))},
+    {},
+])
+def test_frequency_monitor(geometry):
+    experiment = build_experiment()
+    wavelength = numpy.array([1310e-9, 1550e-9])
+    monitor = experiment.add_frequency_monitor(wavelength=wavelength, **geometry)
+
+    experiment.run_fdtd(recording='all')
+
+    phasor = numpy.exp(-1j * numpy.outer(monitor.omega, experiment.grid.time_stamp)) * experiment.grid.dt
+    history = experiment.Ez_t[:, monitor.rows, monitor.cols]
+    expected = (phasor @ history).reshape((wavelength.size, *monitor.spatial_shape))
+
+    assert monitor.data.shape == expected.shape
+    assert numpy.allclose(monitor.data, expected, rtol=0, atol=1e-9 * abs(expected).max())
+
+# -
@@ -0,0 +1,167 @@
+import os
+import sys
+import types
+import shutil
+import threading
+import pytest
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+
+
+def build_experiment():
+    grid = Grid(resolution=0.1e-6, size_x=8e-6, size_y=6e-6, n_steps=60)
+    experiment = Experiment(grid=grid)
+
+    experiment.add_circle(position=('60%', '50%'), epsilon_r=2, radius=1e-6)
+    experiment.add_line_source(wavelength=1550e-9, point_0=('25%', '20%'), point_1=('25%', '80%'), amplitude=10)
+    experiment.add_point_detector(position=('80%', '50%'))
+    experiment.add_frequency_monitor(wavelength=1550e-9, position=('70%', '40%'))
+    experiment.add_cpml(width=10)
+
+    return experiment
+
+
+# Test that the coefficients of a band of rows are the rows of the full grid coefficients
+def test_band_coefficients():
+    experiment = build_experiment()
+    experiment.add_pml(order=1, width=10, sigma_max=5000)
+
+    full = experiment.get_update_coefficients()
+    band = experiment.get_update_coefficients(rows=(20, 45))
+
+    for name in ['Db_x', 'Db_y', 'Cb_x', 'Cb_y', 'Ca']:
+        assert numpy.array_equal(getattr(full, name)[20:45], getattr(band, name))
+
+
+# Test that a source table restricted to a band of rows only writes the owned cells
+def test_restricted_source_table():
+    grid = Grid(resolution=0.1e-6, size_x=8e-6, size_y=6e-6, n_steps=60)
+    experiment = Experiment(grid=grid)
+    experiment.add_line_source(wavelength=1550e-9, point_0=('20%', '50%'), point_1=('80%', '50%'), amplitude=10)
+    n_y = grid.n_y
+
+    table = experiment.get_source_table()
+    full = numpy.zeros(grid.shape)
+    table.inject(full, 20)
+
+    rows = table.index // n_y
+    start, stop = rows.min() + 1, rows.max()
+    row_offset = start - 1
+
+    table.restrict(owned_rows=(start, stop), row_offset=row_offset, n_y=n_y)
+    local = numpy.zeros((stop - row_offset + 1, n_y))
+    table.inject(local, 20)
+
+    assert numpy.array_equal(local[1:-1], full[start:stop])
+    assert not local[0].any() and not local[-1].any()
+
+
+class ThreadCommunicator:
+    """
+    Communicator of one rank among threads, implementing the calls of the distributed engine.
+    """
+    PROC_NULL = -1
+
+    def __init__(self, rank, shared):
+        self.rank, self.shared = rank, shared
+
+    def Get_rank(self):
+        return self.rank
+
+    def Get_size(self):
+        return self.shared['barrier'].parties
+
+    def Sendrecv(self, sendbuf, dest, recvbuf, source):
+        if dest != self.PROC_NULL:
+            self.shared[(self.rank, dest)] = numpy.array(sendbuf)
+        self.shared['barrier'].wait()
+        if source != self.PROC_NULL:
+            recvbuf[...] = self.shared.pop((source, self.rank))
+        self.shared['barrier'].wait()
+
+    def gather(self, value, root=0):
+        self.shared[('gather', self.rank)] = value
+        self.shared['barrier'].wait()
+        values = [self.shared[('gather', rank)] for rank in range(self.Get_size())] if self.rank == root else None
+        self.shared['barrier'].wait()
+        return values
+
+    def Gatherv(self, sendbuf, recvbuf, root=0):
+        values = self.gather(numpy.array(sendbuf), root=root)
+        if self.rank == root:
+            receive, _ = recvbuf
+            receive[...] = numpy.concatenate(values)
+
+
+# Test that two ranks, each sampling only its own cells, gather exactly the serial detectors and monitors
+def test_two_ranks_match_serial(monkeypatch):
+    module = types.ModuleType('mpi4py')
+    module.MPI = types.SimpleNamespace(PROC_NULL=ThreadCommunicator.PROC_NULL, COMM_WORLD=None)
+    monkeypatch.setitem(sys.modules, 'mpi4py', module)
+    from LightWave2D.distributed import DistributedExperiment
+
+    reference = build_experiment()
+    reference.add_frequency_monitor(wavelength=[1310e-9, 1550e-9], point_0=('20%', '30%'), point_1=('80%', '30%'))
+    reference.run_fdtd(recording='none')
+
+    shared = dict(barrier=threading.Barrier(2, timeout=60))
+    experiments, errors = [], []
+
+    def run(rank):
+        try:
+            DistributedExperiment(experiment=experiments[rank], comm=ThreadCommunicator(rank, shared)).run_fdtd()
+        except Exception as error:
+            errors.append(error)
+            shared['barrier'].abort()
+
+    for _ in range(2):
+        experiment = build_experiment()
+        experiment.add_frequency_monitor(wavelength=[1310e-9, 1550e-9], point_0=('20%', '30%'), point_1=('80%', '30%'))
+        experiments.append(experiment)
+
+    threads = [threading.Thread(target=run, args=(rank,)) for rank in range(2)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    assert not errors, errors
+
+    for serial, parallel in zip(reference.detectors, experiments[0].detectors):
+        assert numpy.array_equal(serial.data, parallel.data)
+
+    assert all(detector.data is None for detector in experiments[1].detectors)
+
+    # The monitor crossing the partition only transforms the owned cells on each rank.
+    line_monitor = experiments[1].detectors[-1]
+    assert line_monitor.real.shape[1] < line_monitor.flat_index.size
+
+
+# Test the example script over two MPI processes
+def test_mpiexec_two_ranks():
+    pytest.importorskip('mpi4py')
+    if shutil.which('mpiexec') is None:
+        pytest.skip('mpiexec is not available')
+
+    from LightWave2D.distributed import launch
+
+    script = os.path.join(os.path.dirname(__file__), '..', '..', 'developments', 'distributed_example.py')
+    launch(script=script, n_ranks=2, mpirun='mpiexec')
+
+
+# Test that the distributed engine on a single rank reproduces the serial engine
+def test_single_rank_matches_serial():
+    pytest.importorskip('mpi4py')
+    from LightWave2D.distributed import DistributedExperiment
+
+    reference = build_experiment()
+    reference.run_fdtd(recording='none')
+
+    distributed = build_experiment()
+    DistributedExperiment(experiment=distributed).run_fdtd()
+
+    for serial, parallel in zip(reference.detectors, distributed.detectors):
+        assert numpy.array_equal(serial.data, parallel.data)
+
+# -
@@ -0,0 +1,55 @@
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.physics import Physics
+from LightWave2D.eigenmode import EigenmodeSolver
+from LightWave2D.frequency_domain import FrequencyDomainExperiment
+
+
+# Test the modes of a closed vacuum box against the discrete Dirichlet spectrum
+def test_closed_box_modes():
+    grid = Grid(resolution=0.1e-6, size_x=4e-6, size_y=3e-6, n_steps=10)
+    experiment = Experiment(grid=grid)
+
+    def get_wavenumber(n, step, order):
+        return 2 / step * numpy.sin(order * numpy.pi / (2 * (n + 1)))
+
+    omega = Physics.c * numpy.hypot(get_wavenumber(grid.n_x, grid.dx, 2), get_wavenumber(grid.n_y, grid.dy, 1))
+
+    # The shift is kept off the eigenvalue, where the shifted operator is singular.
+    solver = EigenmodeSolver(experiment=experiment, wavelength=2 * numpy.pi * Physics.c / omega * (1 + 1e-4), n_modes=3)
+    eigenfrequency = solver.solve()
+
+    numpy.testing.assert_allclose(eigenfrequency[0], omega, rtol=1e-9)
+    assert solver.modes.shape == (3, *grid.shape)
+    assert numpy.isclose(abs(solver.modes[0]).max(), 1)
+
+
+# Test that the modes of an open cavity leak through the PML
+def test_open_cavity_modes():
+    grid = Grid(resolution=0.1e-6, size_x=6e-6, size_y=6e-6, n_steps=10)
+    experiment = Experiment(grid=grid)
+    experiment.add_circle(position=('50%', '50%'), radius=1.5e-6, epsilon_r=9)
+    experiment.add_cpml(width=10)
+
+    solver = EigenmodeSolver(experiment=experiment, wavelength=1550e-9, n_modes=4)
+    eigenfrequency = solver.solve()
+
+    assert eigenfrequency.shape == (4,)
+    assert eigenfrequency[0].imag > 0
+    assert solver.quality_factor[0] > 1
+    assert numpy.all(abs(eigenfrequency - solver.omega) <= abs(eigenfrequency[-1] - solver.omega))
+
+
+# Test that the eigenmode and frequency domain solvers share the stretched Laplacian
+def test_shared_laplacian():
+    grid = Grid(resolution=0.1e-6, size_x=4e-6, size_y=3e-6, n_steps=10)
+    experiment = Experiment(grid=grid)
+    experiment.add_pml(order=1, width=8, sigma_max=5000)
+
+    solver = EigenmodeSolver(experiment=experiment, wavelength=1550e-9)
+    frequency_domain = FrequencyDomainExperiment(experiment=experiment, wavelength=1550e-9)
+
+    assert (solver.laplacian.get_matrix(omega=solver.omega) != frequency_domain.get_laplacian()).nnz == 0
+
+# -
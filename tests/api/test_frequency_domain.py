@@ -0,0 +1,84 @@
+import pytest
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.physics import Physics
+from LightWave2D.frequency_domain import FrequencyDomainExperiment
+
+
+def build_experiment(n_steps=10, mode='soft'):
+    grid = Grid(resolution=0.1e-6, size_x=6e-6, size_y=6e-6, n_steps=n_steps)
+    experiment = Experiment(grid=grid)
+
+    experiment.add_circle(position=('60%', '50%'), epsilon_r=2, radius=0.8e-6)
+    experiment.add_point_source(wavelength=1550e-9, position=('30%', '50%'), amplitude=1, mode=mode)
+    experiment.add_cpml(width=10)
+
+    return experiment
+
+
+def test_solution_satisfies_the_operator():
+    solver = FrequencyDomainExperiment(experiment=build_experiment(), wavelength=1550e-9)
+    Ez = solver.solve()
+
+    right_hand_side = 1j * solver.omega * Physics.mu_0 * solver.get_current().ravel()
+    residual = solver.operator @ Ez.ravel() - right_hand_side
+
+    assert numpy.linalg.norm(residual) < 1e-8 * numpy.linalg.norm(right_hand_side)
+    assert solver.Ez is Ez
+
+
+# Test that the factorization is reused and that stacked right-hand sides match single solves
+def test_factorization_reuse():
+    solver = FrequencyDomainExperiment(experiment=build_experiment(), wavelength=1550e-9)
+
+    first = solver.solve()
+    factorization = solver.factorization
+
+    other = numpy.zeros(solver.grid.shape, dtype=complex)
+    other[20, 40] = 1
+    second = solver.solve(other)
+    assert solver.factorization is factorization
+
+    stacked = solver.solve(numpy.stack([solver.get_current(), other]))
+    assert numpy.allclose(stacked[0], first)
+    assert numpy.allclose(stacked[1], second)
+
+
+def test_iterative_matches_direct():
+    direct = FrequencyDomainExperiment(experiment=build_experiment(), wavelength=1550e-9).solve()
+    iterative = FrequencyDomainExperiment(experiment=build_experiment(), wavelength=1550e-9, solver='iterative').solve()
+
+    assert numpy.allclose(iterative, direct, rtol=1e-5, atol=1e-6 * abs(direct).max())
+
+
+def test_no_matching_source():
+    solver = FrequencyDomainExperiment(experiment=build_experiment(), wavelength=1310e-9)
+
+    with pytest.raises(ValueError):
+        solver.solve()
+
+
+def test_hard_source():
+    experiment = build_experiment(mode='hard')
+    solver = FrequencyDomainExperiment(experiment=experiment, wavelength=1550e-9)
+
+    with pytest.raises(ValueError):
+        solver.get_current()
+
+
+# Test that the solution has the shape of the steady state of a soft source time domain run
+def test_matches_time_domain_steady_state():
+    experiment = build_experiment(n_steps=800)
+    monitor = experiment.add_frequency_monitor(wavelength=1550e-9, region=(('15%', '15%'), ('85%', '85%')))
+    experiment.run_fdtd(recording='none')
+
+    Ez = FrequencyDomainExperiment(experiment=experiment, wavelength=1550e-9).solve()
+    x_slice, y_slice = slice(monitor.p0.x_index, monitor.p1.x_index + 1), slice(monitor.p0.y_index, monitor.p1.y_index + 1)
+
+    time_domain, frequency_domain = monitor.data[0].ravel(), Ez[x_slice, y_slice].ravel()
+    correlation = abs(numpy.vdot(time_domain, frequency_domain)) / (numpy.linalg.norm(time_domain) * numpy.linalg.norm(frequency_domain))
+
+    assert correlation > 0.9
+
+# -
@@ -0,0 +1,70 @@
+import pytest
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.physics import Physics
+from LightWave2D.harmonic_inversion import HarmonicInversion
+
+wavelength = numpy.array([1550e-9, 1500e-9])
+quality_factor = numpy.array([2e3, 5e2])
+amplitude = numpy.array([1.0, 0.3])
+
+
+def get_trace(time):
+    omega = 2 * numpy.pi * Physics.c / wavelength
+    decay_rate = omega / (2 * quality_factor)
+
+    oscillation = amplitude * numpy.cos(omega * time[:, None] + 0.4) * numpy.exp(-decay_rate * time[:, None])
+
+    return oscillation.sum(axis=-1)
+
+
+# Test that close resonances are recovered from a trace far shorter than their ring-down time
+def test_harmonic_inversion():
+    grid = Grid(resolution=0.1e-6, size_x=4e-6, size_y=4e-6, n_steps=600)
+    trace = get_trace(grid.time_stamp)
+
+    resonances = HarmonicInversion(trace=trace, dt=grid.dt)
+
+    assert resonances.wavelength.size == 2
+    numpy.testing.assert_allclose(resonances.wavelength, wavelength, rtol=1e-8)
+    numpy.testing.assert_allclose(resonances.quality_factor, quality_factor, rtol=1e-6)
+    numpy.testing.assert_allclose(resonances.amplitude, amplitude, rtol=1e-6)
+    numpy.testing.assert_allclose(resonances.reconstruct(grid.time_stamp), trace, atol=1e-8)
+
+
+# Test the detector entry point, the start time and the wavelength band
+def test_detector_resonances():
+    grid = Grid(resolution=0.1e-6, size_x=4e-6, size_y=4e-6, n_steps=900)
+    experiment = Experiment(grid=grid)
+    detector = experiment.add_point_detector(position=('50%', '50%'))
+
+    trace = get_trace(grid.time_stamp)
+    trace[:300] = numpy.random.default_rng(0).normal(size=300)
+    detector.data = trace
+
+    resonances = detector.get_resonances(start_time=grid.time_stamp[300], stride=2, wavelength_range=(1520e-9, 1600e-9))
+
+    assert resonances.wavelength.size == 1
+    numpy.testing.assert_allclose(resonances.wavelength, wavelength[:1], rtol=1e-8)
+    numpy.testing.assert_allclose(resonances.quality_factor, quality_factor[:1], rtol=1e-6)
+
+
+# Test that a long trace is decimated from the band and inverted with a capped pencil
+def test_long_trace():
+    grid = Grid(resolution=0.1e-6, size_x=4e-6, size_y=4e-6, n_steps=20000)
+    trace = get_trace(grid.time_stamp)
+
+    resonances = HarmonicInversion(trace=trace, dt=grid.dt, wavelength_range=(1450e-9, 1600e-9), max_pencil=300)
+
+    assert resonances.stride == HarmonicInversion.get_stride(dt=grid.dt, wavelength_range=(1450e-9, 1600e-9)) > 1
+    assert resonances.pencil == 300
+    numpy.testing.assert_allclose(resonances.wavelength, wavelength, rtol=1e-8)
+    numpy.testing.assert_allclose(resonances.quality_factor, quality_factor, rtol=1e-6)
+
+
+def test_harmonic_inversion_short_trace():
+    with pytest.raises(ValueError):
+        HarmonicInversion(trace=numpy.ones(3), dt=1e-16)
+
+# -
@@ -0,0 +1,59 @@
+import pytest
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.source import PointSource
+from LightWave2D.impulse_response import ImpulseResponse
+
+
+def build_experiment(mode='hard', wavelength=1550e-9):
+    grid = Grid(resolution=0.1e-6, size_x=8e-6, size_y=6e-6, n_steps=300)
+    experiment = Experiment(grid=grid)
+
+    experiment.add_point_source(position=('30%', '50%'), wavelength=wavelength, mode=mode)
+    experiment.add_circle(position=('55%', '50%'), radius=0.8e-6, epsilon_r=2)
+    experiment.add_point_detector(position=('70%', '50%'))
+    experiment.add_point_detector(position=('50%', '20%'))
+    experiment.add_cpml(width=10)
+
+    return experiment
+
+
+# Test that the convolution with the impulse response matches a direct run, for any wavelength list
+@pytest.mark.parametrize('mode', ['hard', 'soft'], ids=['hard', 'soft'])
+def test_impulse_response(mode):
+    experiment = build_experiment(mode=mode)
+    impulse_response = ImpulseResponse(experiment, source=experiment.sources[0])
+
+    for wavelength in [1550e-9, [1000e-9, 1310e-9, 1550e-9]]:
+        reference = build_experiment(mode=mode, wavelength=wavelength)
+        reference.run_fdtd(recording='none')
+
+        traces = impulse_response.get_traces(reference.sources[0])
+        scale = abs(traces).max()
+
+        for detector, trace in zip(reference.detectors, traces):
+            numpy.testing.assert_allclose(trace, detector.data, rtol=0, atol=1e-9 * scale)
+
+
+# Test that the experiment is not modified and that other cells are refused
+def test_impulse_response_source_check():
+    experiment = build_experiment()
+    impulse_response = ImpulseResponse(experiment, source=experiment.sources[0])
+
+    assert numpy.all(experiment.detectors[0].data == 0)
+    assert len(experiment.sources) == 1
+
+    other = PointSource(grid=experiment.grid, position=('40%', '50%'), wavelength=1550e-9)
+    with pytest.raises(ValueError):
+        impulse_response.get_traces(other)
+
+
+def test_impulse_response_non_linear():
+    experiment = build_experiment()
+    experiment.add_circle(position=('80%', '80%'), radius=0.5e-6, epsilon_r=2, chi_2=1e10)
+
+    with pytest.raises(ValueError):
+        ImpulseResponse(experiment, source=experiment.sources[0])
+
+# -
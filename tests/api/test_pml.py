@@ -0,0 +1,38 @@
+import pytest
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.pml import PML
+
+
+def reference_sigma(grid, width, sigma_max, order):
+    sigma_x = numpy.zeros(grid.shape)
+    sigma_y = numpy.zeros(grid.shape)
+
+    for i in range(grid.n_x):
+        for j in range(grid.n_y):
+            if i < width:
+                sigma_x[i, j] = sigma_max * ((width - i) / width) ** order
+            elif i >= grid.n_x - width:
+                sigma_x[i, j] = sigma_max * ((i - (grid.n_x - width - 1)) / width) ** order
+
+            if j < width:
+                sigma_y[i, j] = sigma_max * ((width - j) / width) ** order
+            elif j >= grid.n_y - width:
+                sigma_y[i, j] = sigma_max * ((j - (grid.n_y - width - 1)) / width) ** order
+
+    return sigma_x, sigma_y
+
+
+# Test that the broadcast 1D ramps reproduce the cell-by-cell profile
+@pytest.mark.parametrize("width, order", [(10, 1), (7, 3), (10, 0)])
+def test_vectorized_profile(width, order):
+    grid = Grid(resolution=0.1e-6, size_x=6e-6, size_y=4e-6, n_steps=10)
+    pml = PML(grid=grid, width=width, sigma_max=5000, order=order)
+
+    sigma_x, sigma_y = reference_sigma(grid, width=width, sigma_max=5000, order=order)
+
+    assert pml.sigma_x.shape == grid.shape
+    assert numpy.allclose(pml.sigma_x, sigma_x, rtol=1e-14, atol=0)
+    assert numpy.allclose(pml.sigma_y, sigma_y, rtol=1e-14, atol=0)
+
+# -
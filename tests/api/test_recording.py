@@ -0,0 +1,68 @@
+import pytest
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.recording import Recording
+
+
+def build_experiment():
+    grid = Grid(resolution=0.1e-6, size_x=8e-6, size_y=6e-6, n_steps=40)
+    experiment = Experiment(grid=grid)
+
+    experiment.add_point_source(wavelength=1550e-9, position=('25%', '50%'), amplitude=10)
+    experiment.add_point_detector(position=('80%', '50%'))
+
+    return experiment
+
+
+def test_recording_policies_match_full_history():
+    reference = build_experiment()
+    reference.run_fdtd(recording='all')
+    assert reference.Ez_t.shape == (reference.grid.n_steps, *reference.grid.shape)
+
+    experiment = build_experiment()
+    experiment.run_fdtd(recording=Recording(every=7))
+    assert numpy.array_equal(experiment.Ez_t, reference.Ez_t[::7])
+
+    experiment = build_experiment()
+    experiment.run_fdtd(recording=Recording(frames=[3, 10, -1]))
+    assert numpy.array_equal(experiment.Ez_t, reference.Ez_t[[3, 10, -1]])
+
+    experiment = build_experiment()
+    recording = Recording(every=1, region=(('50%', '25%'), ('75%', '75%')))
+    experiment.run_fdtd(recording=recording)
+    assert numpy.array_equal(experiment.Ez_t, reference.Ez_t[:, recording.x_slice, recording.y_slice])
+    assert experiment.Ez_t.shape[1:] == (recording.x_stamp.size, recording.y_stamp.size)
+
+
+@pytest.mark.parametrize('frames', [[40], [-41], [3, 250]], ids=['past_end', 'before_start', 'far_past_end'])
+def test_out_of_range_frames(frames):
+    experiment = build_experiment()
+
+    with pytest.raises(ValueError):
+        experiment.run_fdtd(recording=Recording(frames=frames))
+
+
+def test_detector_without_recording():
+    reference = build_experiment()
+    reference.run_fdtd(recording='all')
+
+    experiment = build_experiment()
+    experiment.run_fdtd(recording='none')
+
+    assert experiment.Ez_t.size == 0
+    assert numpy.array_equal(experiment.detectors[0].data, reference.detectors[0].data)
+
+
+# Test that the in-loop gather matches a post-hoc slice of the full history
+def test_streaming_detectors():
+    experiment = build_experiment()
+    experiment.add_point_detector(position=('60%', '30%'), coherent=False)
+    experiment.run_fdtd(recording='all')
+
+    for detector in experiment.detectors:
+        trace = experiment.Ez_t[:, detector.p0.x_index, detector.p0.y_index]
+        expected = trace if detector.coherent else abs(trace)
+        assert numpy.array_equal(detector.data, expected)
+
+# -
@@ -1,4 +1,5 @@
 import pytest
+import numpy
 from unittest.mock import MagicMock, patch
 from LightWave2D.grid import Grid
 from LightWave2D.experiment import Experiment
@@ -44,6 +45,75 @@ def test_add_sources(method, params):
     assert source in experiment.sources  # Assuming sources is a list of added elements
 
 
+# Test that the waveform tables reproduce the values written step by step
+@pytest.mark.parametrize("method, params", [
+    ('add_point_source', {'position': ('25%', '50%'), 'wavelength': [1310e-9, 1550e-9], 'amplitude': 2}),
+    ('add_impulsion', {'position': ('25%', '50%'), 'duration': 3e-15, 'delay': 1e-14}),
+    ('add_impulsion', {'position': ('25%', '50%'), 'duration': 3e-15, 'delay': 1e-14, 'wavelength': 1550e-9}),
+    ('add_line_source', {'point_0': ('10%', '10%'), 'point_1': ('10%', '90%'), 'wavelength': 1550e-9})
+])
+def test_source_waveform(method, params):
+    grid = Grid(resolution=0.1e-6, size_x=5e-6, size_y=5e-6, n_steps=50)
+    experiment = Experiment(grid=grid)
+    source = getattr(experiment, method)(**params)
+
+    waveform = numpy.broadcast_to(source.get_waveform(grid.time_stamp), (grid.n_steps, source.flat_index.size))
+
+    field = numpy.zeros(grid.shape)
+    for iteration, time in enumerate(grid.time_stamp):
+        source.add_source_to_field(field, time=time)
+        assert numpy.array_equal(field.reshape(-1)[source.flat_index], waveform[iteration])
+
+
+# Test that the merged table injects a phased array and overlapping sources like sequential calls
+def test_source_table():
+    grid = Grid(resolution=0.1e-6, size_x=5e-6, size_y=5e-6, n_steps=50)
+    experiment = Experiment(grid=grid)
+
+    for index, x in enumerate(numpy.linspace(20, 80, 7)):
+        experiment.add_point_source(position=(f'{x}%', '30%'), wavelength=1550e-9 * (1 + 0.1 * index), amplitude=index + 1)
+
+    experiment.add_line_source(point_0=('20%', '10%'), point_1=('20%', '90%'), wavelength=1310e-9)
+    experiment.add_impulsion(position=('20%', '50%'), duration=3e-15, delay=1e-14)
+
+    table = experiment.get_source_table()
+
+    expected = numpy.zeros(grid.shape)
+    field = numpy.zeros(grid.shape)
+    for iteration, time in enumerate(grid.time_stamp):
+        for source in experiment.sources:
+            source.add_source_to_field(expected, time=time)
+
+        table.inject(field, iteration)
+        assert numpy.array_equal(field, expected)
+
+
+# Test that soft sources add to the field and mix with hard sources like sequential calls
+def test_soft_source_table():
+    grid = Grid(resolution=0.1e-6, size_x=5e-6, size_y=5e-6, n_steps=50)
+    experiment = Experiment(grid=grid)
+
+    experiment.add_point_source(position=('30%', '50%'), wavelength=1550e-9, mode='soft')
+    experiment.add_line_source(point_0=('30%', '10%'), point_1=('30%', '90%'), wavelength=1310e-9)
+    experiment.add_point_source(position=('30%', '50%'), wavelength=1000e-9, mode='soft')
+    experiment.add_impulsion(position=('60%', '50%'), duration=3e-15, delay=1e-14, mode='soft')
+    experiment.add_impulsion(position=('60%', '50%'), duration=3e-15, delay=2e-14, mode='soft')
+
+    table = experiment.get_source_table()
+    assert table.has_soft
+
+    rng = numpy.random.default_rng(0)
+    for iteration, time in enumerate(grid.time_stamp):
+        expected = rng.normal(size=grid.shape)
+        field = expected.copy()
+
+        for source in experiment.sources:
+            source.add_source_to_field(expected, time=time)
+
+        table.inject(field, iteration)
+        assert numpy.array_equal(field, expected)
+
+
 # Test adding a PML
 def test_add_pml():
     grid = Grid(resolution=0.1e-6, size_x=30e-6, size_y=30e-6, n_steps=500)
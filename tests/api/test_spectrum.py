@@ -0,0 +1,122 @@
+import pytest
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.physics import Physics
+from LightWave2D.source import Impulsion
+from LightWave2D.spectrum import TransmissionSpectrum
+
+wavelength = numpy.linspace(1300e-9, 1700e-9, 5)
+# The lines span the cells 12 to 68 of the 80 cells along y, out of the 10 cells of CPML.
+input_line = (('35%', '15%'), ('35%', '85%'))
+output_line = (('75%', '15%'), ('75%', '85%'))
+
+
+def build_experiment(epsilon_r=None, n_steps=1200):
+    grid = Grid(resolution=0.1e-6, size_x=10e-6, size_y=8e-6, n_steps=n_steps)
+    experiment = Experiment(grid=grid)
+
+    if epsilon_r is not None:
+        experiment.add_circle(position=('55%', '50%'), radius=1e-6, epsilon_r=epsilon_r)
+
+    experiment.add_cpml(width=10)
+
+    return experiment
+
+
+def get_spectrum(experiment):
+    return TransmissionSpectrum(
+        experiment=experiment,
+        wavelength=wavelength,
+        source_position=('20%', '50%'),
+        input_line=input_line,
+        output_line=output_line
+    )
+
+
+# Test that a device identical to the reference does not reflect
+def test_spectrum_without_device():
+    spectrum = get_spectrum(build_experiment())
+    transmission, reflection = spectrum.run()
+
+    assert transmission.shape == reflection.shape == wavelength.shape
+    assert numpy.all(reflection == 0)
+    assert numpy.all(transmission > 0)
+
+
+# Test that a scatterer reflects, that the reference run is reused and that the spectra stay physical
+def test_spectrum_with_device():
+    spectrum = get_spectrum(build_experiment(epsilon_r=4))
+    transmission, reflection = spectrum.run()
+    reference_input = spectrum.reference_input
+
+    assert numpy.all(reflection > 0)
+    assert numpy.all(transmission + reflection < 1.05)
+
+    other_transmission, _ = spectrum.run(build_experiment(epsilon_r=2))
+    assert spectrum.reference_input is reference_input
+    assert not numpy.allclose(other_transmission, transmission)
+
+
+def get_continuous_wave_transmission(spectrum, index, epsilon_r):
+    """
+    Transmission at wavelength[index] from continuous soft point sources, through the lines and with the flux of the spectrum.
+
+    The runs last 180 to 200 periods, so that the turn-on transient weighs little in the transform of the steady state.
+    """
+    fluxes = []
+    for experiment, line in [(build_experiment(n_steps=4000), input_line), (build_experiment(epsilon_r=epsilon_r, n_steps=4000), output_line)]:
+        experiment.add_point_source(wavelength=wavelength[index], position=('20%', '50%'), amplitude=1, mode='soft')
+        monitor = spectrum.get_line_monitor(experiment, line)
+        experiment.run_fdtd(recording='none')
+
+        fluxes.append(spectrum.get_flux(monitor.data, vertical=True)[index])
+
+    incident, transmitted = fluxes
+    return abs(transmitted) / incident
+
+
+# Test that the transmission of the pulsed run matches the one of continuous runs at two wavelengths of the band
+def test_spectrum_matches_continuous_wave():
+    spectrum = get_spectrum(build_experiment(epsilon_r=4))
+    transmission, _ = spectrum.run()
+
+    for index in [1, 3]:
+        continuous = get_continuous_wave_transmission(spectrum, index=index, epsilon_r=4)
+        assert transmission[index] == pytest.approx(continuous, rel=0.05)
+
+
+# Test that the spectrum of the pulse, centred on the band by its carrier, stays above the minimum amplitude over the band
+def test_pulse_covers_band():
+    spectrum = get_spectrum(build_experiment())
+    grid = spectrum.grid
+
+    pulse = Impulsion(
+        grid=grid,
+        position=('20%', '50%'),
+        duration=spectrum.duration,
+        delay=spectrum.delay,
+        wavelength=spectrum.carrier_wavelength
+    )
+
+    omega = 2 * numpy.pi * Physics.c / numpy.append(wavelength, spectrum.carrier_wavelength)
+    amplitude = abs(numpy.exp(-1j * numpy.outer(omega, grid.time_stamp)) @ pulse.get_waveform(grid.time_stamp)[:, 0])
+    amplitude /= amplitude[-1]
+
+    assert numpy.all(amplitude[:-1] >= 0.9e-2)
+    assert numpy.all(amplitude[:-1] <= 1)
+
+
+def test_spectrum_oblique_line():
+    spectrum = TransmissionSpectrum(
+        experiment=build_experiment(),
+        wavelength=wavelength,
+        source_position=('20%', '50%'),
+        input_line=(('35%', '15%'), ('40%', '85%')),
+        output_line=output_line
+    )
+
+    with pytest.raises(ValueError):
+        spectrum.run()
+
+# -
@@ -0,0 +1,233 @@
+import pytest
+import tracemalloc
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.stepper import NumpyStepper
+from LightWave2D.decomposition import SlabPartition
+from LightWave2D.recording import Recording
+
+
+def build_experiment(**kwargs):
+    grid = Grid(resolution=0.1e-6, size_x=8e-6, size_y=6e-6, n_steps=60)
+    experiment = Experiment(grid=grid, **kwargs)
+
+    experiment.add_circle(position=('60%', '50%'), epsilon_r=2, radius=1e-6)
+    experiment.add_point_source(wavelength=1550e-9, position=('25%', '50%'), amplitude=10)
+    experiment.add_point_detector(position=('80%', '50%'))
+    experiment.add_pml(order=1, width=10, sigma_max=5000)
+
+    return experiment
+
+
+# Test that the compiled backend reproduces the numpy engine
+def test_native_backend_matches_numpy():
+    pytest.importorskip('LightWave2D.binary.interface_yee')
+
+    reference = build_experiment()
+    reference.run_fdtd(backend='numpy')
+
+    native = build_experiment()
+    native.run_fdtd(backend='native')
+
+    assert numpy.array_equal(reference.Ez_t, native.Ez_t)
+    assert numpy.array_equal(reference.detectors[0].data, native.detectors[0].data)
+
+
+# Test that the temporal tiling reproduces the plain leapfrog, blocks being cut at the recorded frames
+@pytest.mark.parametrize('steps_per_block', [1, 7])
+def test_tiled_backend_matches_numpy(steps_per_block):
+    pytest.importorskip('LightWave2D.binary.interface_yee')
+    recording = dict(every=None, frames=[10, 33, -1])
+
+    reference = build_experiment()
+    reference.run_fdtd(backend='numpy', recording=Recording(**recording))
+
+    tiled = build_experiment()
+    tiled.run_tiled_fdtd(recording=Recording(**recording), tile_shape=(16, 12), steps_per_block=steps_per_block)
+
+    assert numpy.array_equal(reference.Ez_t, tiled.Ez_t)
+    assert numpy.array_equal(reference.detectors[0].data, tiled.detectors[0].data)
+    assert (tiled.n_steps_run, tiled.stop_reason) == (reference.n_steps_run, reference.stop_reason)
+
+
+# Test that the tiled backend records no frame by default and warns when every step cuts a block
+def test_tiled_backend_recording():
+    pytest.importorskip('LightWave2D.binary.interface_yee')
+
+    experiment = build_experiment()
+    experiment.run_fdtd(backend='tiled')
+    assert experiment.Ez_t.shape[0] == 0
+
+    with pytest.warns(UserWarning):
+        experiment.run_fdtd(backend='tiled', recording='all')
+
+
+# Test that the slab decomposition over threads reproduces the serial engine
+@pytest.mark.parametrize('n_workers', [1, 3, 7])
+def test_threaded_backend_matches_numpy(n_workers):
+    reference = build_experiment()
+    reference.run_fdtd(backend='numpy')
+
+    threaded = build_experiment()
+    threaded.run_fdtd(backend='threaded', n_workers=n_workers)
+
+    assert numpy.array_equal(reference.Ez_t, threaded.Ez_t)
+    assert numpy.array_equal(reference.detectors[0].data, threaded.detectors[0].data)
+
+
+# Test that the worker threads are shut down even when the run fails
+def test_threaded_backend_releases_workers(monkeypatch):
+    steppers = []
+    get_stepper = Experiment.get_stepper
+
+    def recording_get_stepper(self, **kwargs):
+        steppers.append(get_stepper(self, **kwargs))
+        return steppers[-1]
+
+    monkeypatch.setattr(Experiment, 'get_stepper', recording_get_stepper)
+
+    class FailingCriterion:
+        def initialize(self, **kwargs):
+            pass
+
+        def is_met(self, iteration, Ez, Hx, Hy):
+            raise RuntimeError("failure inside the time loop")
+
+    experiment = build_experiment()
+    with pytest.raises(RuntimeError):
+        experiment.run_fdtd(backend='threaded', n_workers=2, stop_criteria=FailingCriterion())
+
+    assert steppers[0].executor._shutdown
+
+
+def test_slab_partition():
+    partition = SlabPartition(n_x=10, n_slabs=3)
+
+    rows = [partition.get_rows(index) for index in range(len(partition))]
+    assert rows[0][0] == 0 and rows[-1][1] == 10
+    assert all(stop == start for (_, stop), (start, _) in zip(rows[:-1], rows[1:]))
+
+    assert partition.get_halo_rows(0) == (0, rows[0][1] + 1)
+    assert partition.get_halo_rows(1) == (rows[1][0] - 1, rows[1][1] + 1)
+
+
+# Test that the single precision mode stores float32 arrays close to the double precision run
+def test_single_precision():
+    reference = build_experiment()
+    reference.run_fdtd()
+
+    single = build_experiment(precision='float32', monitor_precision='float64')
+    monitor = single.add_frequency_monitor(wavelength=1550e-9, position=('70%', '50%'))
+    single.run_fdtd()
+
+    assert single.Ez_t.dtype == numpy.float32
+    assert single.get_update_coefficients().Ca.dtype == numpy.float32
+    assert single.detectors[0].data.dtype == numpy.float32
+    assert monitor.real.dtype == numpy.float64
+
+    scale = numpy.abs(reference.Ez_t).max()
+    assert numpy.allclose(single.Ez_t, reference.Ez_t, atol=1e-4 * scale, rtol=0)
+
+
+def test_native_single_precision_matches_numpy():
+    pytest.importorskip('LightWave2D.binary.interface_yee')
+
+    reference = build_experiment(precision='float32')
+    reference.run_fdtd(backend='numpy')
+
+    native = build_experiment(precision='float32')
+    native.run_fdtd(backend='native')
+
+    assert numpy.array_equal(reference.Ez_t, native.Ez_t)
+
+
+def test_invalid_backend():
+    experiment = build_experiment()
+    with pytest.raises(ValueError):
+        experiment.run_fdtd(backend='fortran')
+
+
+def test_update_coefficients():
+    experiment = build_experiment()
+    coefficients = experiment.get_update_coefficients()
+
+    for array in [coefficients.Db_x, coefficients.Db_y, coefficients.Cb_x, coefficients.Cb_y, coefficients.Ca]:
+        assert array.shape == experiment.grid.shape
+        assert array.flags.c_contiguous
+
+    assert coefficients.has_damping
+
+    experiment.pml = None
+    assert not experiment.get_update_coefficients().has_damping
+
+
+# Test that a buffered numpy step does not create any grid-sized temporary
+def test_numpy_step_does_not_allocate():
+    experiment = build_experiment()
+    stepper = NumpyStepper(coefficients=experiment.get_update_coefficients())
+    Ez, Hx, Hy = (numpy.zeros(experiment.grid.shape) for _ in range(3))
+
+    tracemalloc.start()
+    current, _ = tracemalloc.get_traced_memory()
+    for _ in range(5):
+        stepper.update_magnetic(Ez, Hx, Hy)
+        stepper.update_electric(Ez, Hx, Hy)
+        stepper.apply_damping(Ez)
+    _, peak = tracemalloc.get_traced_memory()
+    tracemalloc.stop()
+
+    assert peak - current < Ez.nbytes / 10
+
+
+def test_field_yee_gradient_out():
+    experiment = build_experiment()
+    field = numpy.random.rand(*experiment.grid.shape)
+    out = numpy.empty((field.shape[0] - 1, field.shape[1])), numpy.empty((field.shape[0], field.shape[1] - 1))
+
+    d_dx, d_dy = experiment.get_field_yee_gradient(field, out=out)
+
+    assert d_dx is out[0] and d_dy is out[1]
+    assert numpy.allclose(d_dx, numpy.diff(field, axis=0) / experiment.grid.dx)
+    assert numpy.allclose(d_dy, numpy.diff(field, axis=1) / experiment.grid.dy)
+
+
+def field_energy(experiment):
+    return (experiment.Ez_t ** 2).sum(axis=(1, 2))
+
+
+# Test that the convolutional PML absorbs an outgoing pulse
+def test_cpml_absorbs_pulse():
+    energies = []
+    for boundary in [None, 'cpml']:
+        grid = Grid(resolution=0.1e-6, size_x=6e-6, size_y=6e-6, n_steps=400)
+        experiment = Experiment(grid=grid)
+        experiment.add_impulsion(duration=3e-15, delay=1e-14, position=('50%', '50%'), amplitude=1)
+        if boundary == 'cpml':
+            cpml = experiment.add_cpml(width=10)
+            assert cpml.sigma_x.shape == (grid.n_x,)
+
+        experiment.run_fdtd()
+        energy = field_energy(experiment)
+        energies.append(energy[-1] / energy.max())
+
+    reflecting, absorbing = energies
+    assert absorbing < 0.1 * reflecting
+
+
+# Test that the CPML reflects less than the PML of the same width, for a source close to a boundary (grazing incidence)
+def test_cpml_outperforms_pml():
+    energies = {}
+    for boundary in ['pml', 'cpml']:
+        grid = Grid(resolution=0.1e-6, size_x=8e-6, size_y=6e-6, n_steps=500)
+        experiment = Experiment(grid=grid)
+        experiment.add_impulsion(duration=3e-15, delay=1e-14, position=('50%', 1.5e-6), amplitude=1)
+        getattr(experiment, f'add_{boundary}')(width=10)
+
+        experiment.run_fdtd()
+        interior = (experiment.Ez_t[:, 10:-10, 10:-10] ** 2).sum(axis=(1, 2))
+        energies[boundary] = interior[-1] / interior.max()
+
+    assert energies['cpml'] < 0.5 * energies['pml']
+
+# -
@@ -0,0 +1,67 @@
+import pytest
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+from LightWave2D.stopping import FieldDecay, MonitorConvergence
+
+
+def build_experiment(n_steps=1000):
+    grid = Grid(resolution=0.1e-6, size_x=8e-6, size_y=6e-6, n_steps=n_steps)
+    experiment = Experiment(grid=grid)
+
+    experiment.add_impulsion(position=('30%', '50%'), duration=2e-15, delay=6e-15, amplitude=10)
+    experiment.add_point_detector(position=('70%', '50%'))
+    experiment.add_cpml(width=10)
+
+    return experiment
+
+
+# Test that a decayed pulse ends the run early, with the same leading steps as a full run
+def test_field_decay():
+    reference = build_experiment()
+    reference.run_fdtd(recording='all')
+
+    experiment = build_experiment()
+    experiment.run_fdtd(recording='all', stop_criteria=FieldDecay(threshold=1e-3, check_every=20))
+
+    n_steps_run = experiment.n_steps_run
+    assert n_steps_run < experiment.grid.n_steps
+    assert n_steps_run % 20 == 0
+    assert experiment.stop_reason is not None
+
+    detector = experiment.detectors[0]
+    assert detector.data.shape == (n_steps_run,)
+    assert numpy.array_equal(detector.data, reference.detectors[0].data[:n_steps_run])
+
+    assert experiment.Ez_t.shape[0] == n_steps_run
+    assert numpy.array_equal(experiment.Ez_t, reference.Ez_t[:n_steps_run])
+
+
+# Test that a run without a met criterion goes to the end
+def test_criterion_not_met():
+    experiment = build_experiment(n_steps=100)
+    experiment.run_fdtd(recording='none', stop_criteria=[FieldDecay(threshold=1e-30)])
+
+    assert experiment.n_steps_run == 100
+    assert experiment.stop_reason is None
+    assert experiment.detectors[0].data.shape == (100,)
+
+
+def test_monitor_convergence_requires_monitor():
+    experiment = build_experiment(n_steps=100)
+
+    with pytest.raises(ValueError):
+        experiment.run_fdtd(recording='none', stop_criteria=MonitorConvergence(window=20))
+
+
+# Test that the transform of a decayed pulse is detected as converged
+def test_monitor_convergence():
+    experiment = build_experiment()
+    experiment.add_frequency_monitor(wavelength=1550e-9, position=('70%', '50%'))
+
+    experiment.run_fdtd(recording='none', stop_criteria=MonitorConvergence(tolerance=1e-3, window=50))
+
+    assert experiment.n_steps_run < experiment.grid.n_steps
+    assert experiment.detectors[1].data.shape == (1,)
+
+# -
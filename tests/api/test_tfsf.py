@@ -0,0 +1,61 @@
+import pytest
+import numpy
+from LightWave2D.grid import Grid
+from LightWave2D.experiment import Experiment
+
+
+def build_experiment():
+    grid = Grid(resolution=0.1e-6, size_x=8e-6, size_y=8e-6, n_steps=150)
+    experiment = Experiment(grid=grid)
+    experiment.add_cpml(width=10)
+
+    return experiment
+
+
+def get_outside_mask(experiment):
+    wave = experiment.plane_wave
+    outside = numpy.ones(experiment.grid.shape, dtype=bool)
+    outside[wave.x_start:wave.x_stop + 1, wave.y_start:wave.y_stop + 1] = False
+    return outside
+
+
+# Test that an empty total-field rectangle does not leak into the scattered-field region
+def test_empty_total_field_does_not_leak():
+    experiment = build_experiment()
+    experiment.add_plane_wave(point_0=('25%', '25%'), point_1=('75%', '75%'), wavelength=1550e-9, duration=4e-15, delay=1.2e-14)
+
+    experiment.run_fdtd(recording='all')
+
+    outside = get_outside_mask(experiment)
+    inside_peak = abs(experiment.Ez_t[:, ~outside]).max()
+    outside_peak = abs(experiment.Ez_t[:, outside]).max()
+
+    assert inside_peak > 0.5
+    assert outside_peak < 1e-9 * inside_peak
+
+
+# Test that a scatterer inside the rectangle radiates into the scattered-field region
+def test_scatterer_radiates():
+    experiment = build_experiment()
+    experiment.add_circle(position=('50%', '50%'), epsilon_r=4, radius=0.8e-6)
+    experiment.add_plane_wave(point_0=('25%', '25%'), point_1=('75%', '75%'), wavelength=1550e-9, duration=4e-15, delay=1.2e-14)
+
+    experiment.run_fdtd(recording='all')
+
+    outside = get_outside_mask(experiment)
+    assert abs(experiment.Ez_t[:, outside]).max() > 1e-3
+
+
+@pytest.mark.parametrize("corners", [
+    (('5%', '25%'), ('75%', '75%')),     # reaches into the CPML
+    (('45%', '25%'), ('75%', '75%')),    # crosses the circle
+])
+def test_invalid_rectangle(corners):
+    experiment = build_experiment()
+    experiment.add_circle(position=('50%', '50%'), epsilon_r=4, radius=0.8e-6)
+    experiment.add_plane_wave(point_0=corners[0], point_1=corners[1], wavelength=1550e-9)
+
+    with pytest.raises(ValueError):
+        experiment.run_fdtd(recording='none')
+
+# -